@@ -0,0 +1,204 @@
+/**************************************************************************/
+/*  AssetPack.cpp                                                         */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "AssetPack.h"
+#define LOG_TAG "AssetPack"
+#include "godot-log.h"
+
+#include "libgodot_jni.h"
+
+#include <android/asset_manager.h>
+#include <android/asset_manager_jni.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+static std::string call_string_method(JNIEnv *env, jobject object, const char *name) {
+	jclass cls = env->GetObjectClass(object);
+	jmethodID method = env->GetMethodID(cls, name, "()Ljava/lang/String;");
+	env->DeleteLocalRef(cls);
+	if (env->ExceptionCheck()) {
+		env->ExceptionClear();
+		return std::string();
+	}
+	jstring value = (jstring)env->CallObjectMethod(object, method);
+	if (env->ExceptionCheck()) {
+		env->ExceptionClear();
+		return std::string();
+	}
+	std::string result = jstring_to_std_string(value, env);
+	env->DeleteLocalRef(value);
+	return result;
+}
+
+static std::string get_files_dir(JNIEnv *env, jobject context) {
+	jclass cls = env->GetObjectClass(context);
+	jmethodID method = env->GetMethodID(cls, "getFilesDir", "()Ljava/io/File;");
+	env->DeleteLocalRef(cls);
+	if (env->ExceptionCheck()) {
+		env->ExceptionClear();
+		return std::string();
+	}
+	jobject dir = env->CallObjectMethod(context, method);
+	if (env->ExceptionCheck() || !dir) {
+		env->ExceptionClear();
+		return std::string();
+	}
+	std::string result = call_string_method(env, dir, "getAbsolutePath");
+	env->DeleteLocalRef(dir);
+	return result;
+}
+
+static bool write_all(int fd, const uint8_t *data, size_t size) {
+	while (size > 0) {
+		ssize_t written = write(fd, data, size);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		data += written;
+		size -= (size_t)written;
+	}
+	return true;
+}
+
+// Copies the asset into p_dest_fd, from a mapping of the APK if it is stored
+// uncompressed, through AAsset_read() otherwise.
+static bool copy_asset(AAsset *asset, int p_dest_fd) {
+	off64_t start = 0;
+	off64_t length = 0;
+	int apk_fd = AAsset_openFileDescriptor64(asset, &start, &length);
+	if (apk_fd >= 0) {
+		// mmap() offsets have to be page aligned.
+		off64_t page = sysconf(_SC_PAGESIZE);
+		off64_t aligned = start & ~(page - 1);
+		size_t map_size = (size_t)(length + (start - aligned));
+		void *map = mmap64(nullptr, map_size, PROT_READ, MAP_PRIVATE, apk_fd, aligned);
+		close(apk_fd);
+		if (map == MAP_FAILED) {
+			LOGE("Unable to map asset: %s", strerror(errno));
+			return false;
+		}
+		madvise(map, map_size, MADV_SEQUENTIAL);
+		bool ok = write_all(p_dest_fd, (const uint8_t *)map + (start - aligned), (size_t)length);
+		munmap(map, map_size);
+		return ok;
+	}
+
+	LOGW("Pack is compressed in the APK, add it to noCompress to map it directly");
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[1 << 20]);
+	int n;
+	while ((n = AAsset_read(asset, buffer.get(), 1 << 20)) > 0) {
+		if (!write_all(p_dest_fd, buffer.get(), (size_t)n)) {
+			return false;
+		}
+	}
+	return n == 0;
+}
+
+static bool stage(const std::string &p_asset, std::string &r_path) {
+	JNIEnv *env = LibGodot::get_jni_env();
+	jobject activity = LibGodot::get_host_activity();
+	AAssetManager *manager = AAssetManager_fromJava(env, LibGodot::get_asset_manager());
+	if (!activity || !manager) {
+		LOGE("Asset manager or host activity not available");
+		return false;
+	}
+
+	std::string files_dir = get_files_dir(env, activity);
+	std::string apk_path = call_string_method(env, activity, "getPackageCodePath");
+	struct stat apk_stat;
+	if (files_dir.empty() || apk_path.empty() || stat(apk_path.c_str(), &apk_stat) != 0) {
+		LOGE("Unable to locate the files directory or the APK");
+		return false;
+	}
+
+	AAsset *asset = AAssetManager_open(manager, p_asset.c_str(), AASSET_MODE_STREAMING);
+	if (!asset) {
+		LOGE("Asset not found: %s", p_asset.c_str());
+		return false;
+	}
+	off64_t length = AAsset_getLength64(asset);
+
+	std::string dir = files_dir + "/godot-packs";
+	mkdir(dir.c_str(), 0700);
+	std::string name = p_asset.substr(p_asset.find_last_of('/') + 1);
+	r_path = dir + "/" + name;
+
+	// The staged copy carries the modification time of the APK it came from.
+	struct stat dest_stat;
+	if (stat(r_path.c_str(), &dest_stat) == 0 && dest_stat.st_size == length && dest_stat.st_mtim.tv_sec == apk_stat.st_mtim.tv_sec && dest_stat.st_mtim.tv_nsec == apk_stat.st_mtim.tv_nsec) {
+		AAsset_close(asset);
+		LOGI("Using staged pack %s", r_path.c_str());
+		return true;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	std::string tmp = r_path + ".tmp";
+	int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd < 0) {
+		AAsset_close(asset);
+		LOGE("Unable to create %s: %s", tmp.c_str(), strerror(errno));
+		return false;
+	}
+	bool ok = copy_asset(asset, fd);
+	AAsset_close(asset);
+	if (ok) {
+		struct timespec times[2] = { apk_stat.st_mtim, apk_stat.st_mtim };
+		ok = futimens(fd, times) == 0;
+	}
+	ok = close(fd) == 0 && ok;
+	if (!ok || rename(tmp.c_str(), r_path.c_str()) != 0) {
+		LOGE("Unable to stage %s: %s", p_asset.c_str(), strerror(errno));
+		unlink(tmp.c_str());
+		return false;
+	}
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	LOGI("Staged pack %s (%lld bytes) in %lld ms", r_path.c_str(), (long long)length, (long long)ms);
+	return true;
+}
+
+bool AssetPack::stage_main_pack(std::vector<std::string> &r_cmdline) {
+	static const std::string prefix = ASSET_PACK_PREFIX;
+	for (size_t i = 0; i + 1 < r_cmdline.size(); i++) {
+		if (r_cmdline[i] != "--main-pack" || r_cmdline[i + 1].compare(0, prefix.size(), prefix) != 0) {
+			continue;
+		}
+		std::string path;
+		if (!stage(r_cmdline[i + 1].substr(prefix.size()), path)) {
+			return false;
+		}
+		r_cmdline[i + 1] = path;
+	}
+	return true;
+}
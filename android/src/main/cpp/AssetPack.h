@@ -0,0 +1,45 @@
+/**************************************************************************/
+/*  AssetPack.h                                                           */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Prefix of a --main-pack argument that names a pack in the APK assets.
+#define ASSET_PACK_PREFIX "asset://"
+
+// Godot reads packs stored in the APK much slower than packs in the private
+// storage of the app. An "asset://" main pack is therefore staged once into
+// the files directory and Godot is started with the staged copy. Packs that
+// are stored uncompressed in the APK are mapped straight from the APK file,
+// compressed ones are streamed through AAssetManager. The copy is reused as
+// long as its size and modification time match the installed APK.
+class AssetPack {
+public:
+	// Rewrites an "asset://" --main-pack argument to the staged file.
+	// Returns false if the pack could not be staged.
+	static bool stage_main_pack(std::vector<std::string> &r_cmdline);
+};
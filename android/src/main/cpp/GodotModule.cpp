@@ -24,9 +24,15 @@
 /**************************************************************************/
 
 #include "GodotModule.h"
+#include "WindowRegistry.h"
 #define LOG_TAG "GodotModule"
 #include "godot-log.h"
 
+#include "AssetPack.h"
+#include "GodotEventStream.h"
+#include "SceneSnapshot.h"
+#include "StartupTrace.h"
+#include "TaskExecutor.h"
 #include "libgodot_android.h"
 #include "libgodot_jni.h"
 #include <godot_cpp/classes/display_server_embedded.hpp>
@@ -42,8 +48,8 @@
 #include <dlfcn.h>
 
 #include <unistd.h>
+#include <chrono>
 #include <map>
-#include <queue>
 #include <string>
 
 typedef GDExtensionObjectPtr (*libgodot_create_godot_instance_android_type)(int p_argc, char *p_argv[], GDExtensionInitializationFunction p_init_func, JNIEnv *env, jobject p_asset_manager, jobject p_net_utils, jobject p_directory_access_handler, jobject p_file_access_handler, jobject p_godot_io_wrapper, jobject p_godot_wrapper, jobject p_class_loader);
@@ -52,15 +58,25 @@ typedef void (*libgodot_destroy_godot_instance_type)(GDExtensionObjectPtr p_godo
 const static char CMD_FUNCTION = 1;
 const static char CMD_EXIT = 2;
 
-class AndroidThread {
+class AndroidThread : public TaskExecutor {
 	std::thread thread;
 	std::mutex mutex;
 	std::condition_variable started;
-	std::queue<std::function<void()>> tasks;
 	ALooper *looper = nullptr;
 	int function_queue_fd = -1;
 	bool quit = false;
 
+protected:
+	void wake() override {
+		ssize_t res = write(function_queue_fd, &CMD_FUNCTION, sizeof(CMD_FUNCTION));
+		if (res < 0) {
+			LOGE("Unable to write to pipe: %d", errno);
+		}
+		if (res != sizeof(CMD_FUNCTION)) {
+			LOGE("Unable to write command fully to pipe");
+		}
+	}
+
 public:
 	AndroidThread() :
 			thread(&AndroidThread::run, this) {
@@ -89,17 +105,7 @@ public:
 
 		switch (cmd) {
 			case CMD_FUNCTION: {
-				std::function<void()> task;
-				{
-					std::lock_guard<std::mutex> lock(self->mutex);
-					if (self->tasks.empty()) {
-						LOGW("Empty queue when processing CMD_FUNCTION");
-						break;
-					}
-					task = std::move(self->tasks.front());
-					self->tasks.pop();
-				}
-				task();
+				self->run_pending();
 			} break;
 			case CMD_EXIT: {
 				self->quit = true;
@@ -112,27 +118,10 @@ public:
 		return 1;
 	}
 
-	void enqueue(std::function<void()> f) {
-		if (thread.get_id() == std::this_thread::get_id()) {
-			f();
-			return;
-		}
-		{
-			std::lock_guard<std::mutex> lock(mutex);
-			tasks.emplace(f);
-		}
-		ssize_t res = write(function_queue_fd, &CMD_FUNCTION, sizeof(CMD_FUNCTION));
-		if (res < 0) {
-			LOGE("Unable to write to pipe: %d", errno);
-		}
-		if (res != sizeof(CMD_FUNCTION)) {
-			LOGE("Unable to write command fully to pipe");
-		}
-	}
-
 	void run() {
 		LOGI("AndroidThread Looper thread started.");
 		LibGodot::get_jni_env(); // Force attaching to Java VM
+		bind_current_thread();
 		{
 			std::lock_guard<std::mutex> lock(mutex);
 
@@ -232,13 +221,34 @@ GDExtensionBool GDE_EXPORT gdextension_default_init(GDExtensionInterfaceGetProcA
 }
 
 static void frameCallback64(int64_t frameTimeNanos, void *data) {
+	static int64_t lastFrameTimeNanos = 0;
+	static int64_t framePeriodNanos = 16666667;
+
 	GodotModule *self = (GodotModule *)data;
 	if (!self->is_paused()) {
 		godot::GodotInstance *instance = self->get_instance();
 		if (!instance) {
 			return;
 		} else if (instance->is_started()) {
+			int64_t period = frameTimeNanos - lastFrameTimeNanos;
+			if (period > 0 && period < 2 * framePeriodNanos) {
+				// Only follow the display rate, skipped frames should not extend the deadline.
+				framePeriodNanos = period;
+			}
+			lastFrameTimeNanos = frameTimeNanos;
+
+			// Both Choreographer and steady_clock use CLOCK_MONOTONIC on Android.
+			TaskExecutor *thread = self->get_thread();
+			bool tracing = !StartupTrace::is_finished();
+			if (tracing) {
+				StartupTrace::mark(STARTUP_FIRST_FRAME_CALLBACK);
+			}
+			thread->begin_frame(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(frameTimeNanos + framePeriodNanos)));
 			instance->iteration();
+			if (tracing) {
+				StartupTrace::mark(STARTUP_FIRST_ITERATION);
+			}
+			thread->run_idle();
 		}
 		AChoreographer *choreographer = AChoreographer_getInstance();
 		AChoreographer_postFrameCallback64(choreographer, frameCallback64, data);
@@ -258,6 +268,10 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 		}
 	}
 
+	StartupTrace::begin();
+	// The arguments as requested, before the snapshot scene is added.
+	std::vector<std::string> requested_args = args;
+	SceneSnapshot::apply(args);
 	void *handle = nullptr;
 	if (!data->func_libgodot_create_godot_instance_android) {
 		libgodot_create_godot_instance_android_type func_libgodot_create_godot_instance_android = nullptr;
@@ -285,17 +299,28 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 		}
 	}
 
+	StartupTrace::mark(STARTUP_LIBRARY_LOADED);
+
 	std::vector<std::string> cmdline{ "apk" };
 	for (std::string arg : args) {
 		cmdline.push_back(arg);
 	}
+	if (!AssetPack::stage_main_pack(cmdline)) {
+		LOGE("Unable to stage the main pack");
+		return nullptr;
+	}
 
 	std::vector<const char *> cargs{};
 	for (const std::string &arg : cmdline) {
 		cargs.push_back(arg.c_str());
 	}
 
+	// The engine picks its FileAccess implementations itself, see FileRoute.h
+	// for which paths reach the Java handlers. A GDExtension cannot register
+	// a FileAccess or DirAccess backend, so the handlers have to be passed as
+	// they are.
 	GDExtensionObjectPtr instance_ptr = nullptr;
+	auto createStart = std::chrono::steady_clock::now();
 	{
 		std::lock_guard lock(_mutex);
 		instance_ptr = data->func_libgodot_create_godot_instance_android(
@@ -326,6 +351,8 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 		return nullptr;
 	}
 
+	StartupTrace::mark(STARTUP_INSTANCE_CREATED);
+	LOGI("Godot instance created in %lld ms", (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - createStart).count());
 	godot::GodotInstance *instance = reinterpret_cast<godot::GodotInstance *>(godot::internal::get_object_instance_binding(instance_ptr));
 
 	// Initialize Android Surface
@@ -345,8 +372,10 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 	godot::Ref<godot::RenderingNativeSurface> nativeSurface(ptr);
 
 	godot::DisplayServerEmbedded::set_native_surface(nativeSurface);
+	StartupTrace::mark(STARTUP_SURFACE_CREATED);
 
 	if (instance->start()) {
+		StartupTrace::mark(STARTUP_INSTANCE_STARTED);
 		AChoreographer *choreographer = AChoreographer_getInstance();
 		AChoreographer_postFrameCallback64(choreographer, frameCallback64, this);
 	}
@@ -360,6 +389,7 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 		data->handle = handle;
 
 		_instance = instance;
+		_instance_args = requested_args;
 	}
 
 	updateWindows(true);
@@ -389,6 +419,9 @@ void GodotModule::destroy_instance() {
 		return;
 	}
 
+	// A snapshot save started on pause still calls into Godot.
+	SceneSnapshot::wait_for_saves();
+
 	if (!data->func_libgodot_destroy_godot_instance) {
 		libgodot_destroy_godot_instance_type func_libgodot_destroy_godot_instance = nullptr;
 #ifndef LIBGODOT_STATIC
@@ -428,8 +461,11 @@ void GodotModule::destroy_instance() {
 		data->mainNativeWindow = nullptr;
 		data->mainSurface = godot::Ref<godot::RenderingNativeSurface>(nullptr);
 
+		GodotEventStream::close_all();
 		data->func_libgodot_destroy_godot_instance(_instance->_owner);
 		_instance = nullptr;
+		_instance_args.clear();
+		WindowRegistry::get_singleton()->reset();
 		godot::GDExtensionBinding::deinit();
 
 		dlclose(data->handle);
@@ -453,7 +489,8 @@ void GodotModule::focus_out() {
 		if (_instance) {
 			_instance->focus_out();
 		}
-	});
+	},
+			TASK_PRIORITY_URGENT);
 	updateState();
 }
 
@@ -466,7 +503,8 @@ void GodotModule::focus_in() {
 		if (_instance) {
 			_instance->focus_in();
 		}
-	});
+	},
+			TASK_PRIORITY_URGENT);
 	updateState();
 }
 
@@ -476,16 +514,54 @@ bool GodotModule::is_paused() {
 	return data->paused;
 }
 
+#ifdef RTN_GODOT_PGO_GENERATE
+#include <cstdio>
+
+extern "C" void __llvm_profile_set_filename(const char *);
+extern "C" int __llvm_profile_write_file(void);
+
+// Apps are usually killed in the background instead of exiting, so the
+// instrumented build writes its profile on every pause.
+static void write_profile() {
+	// The runtime keeps the pointer, the path has to outlive it.
+	static std::string path;
+	if (path.empty()) {
+		// The process name is the package name, which gives the files directory.
+		char name[256] = {};
+		size_t read = 0;
+		FILE *f = fopen("/proc/self/cmdline", "r");
+		if (f) {
+			read = fread(name, 1, sizeof(name) - 1, f);
+			fclose(f);
+		}
+		if (read == 0 || name[0] == 0) {
+			LOGE("Unable to read the process name, the PGO profile is not written");
+			return;
+		}
+		path = std::string("/data/data/") + name + "/files/rtngodot-%p.profraw";
+		__llvm_profile_set_filename(path.c_str());
+	}
+	if (__llvm_profile_write_file() != 0) {
+		LOGE("Unable to write the PGO profile");
+	}
+}
+#endif
+
 void GodotModule::appPause() {
+#ifdef RTN_GODOT_PGO_GENERATE
+	write_profile();
+#endif
 	std::lock_guard lock(_mutex);
 	AndroidPlatformData *data = static_cast<AndroidPlatformData *>(_data);
 	data->in_background = true;
 	data->thread.enqueue([this]() {
 		std::lock_guard lock(_mutex);
 		if (_instance) {
+			SceneSnapshot::capture();
 			_instance->pause();
 		}
-	});
+	},
+			TASK_PRIORITY_URGENT);
 	updateState();
 }
 
@@ -497,7 +573,8 @@ void GodotModule::appResume() {
 		if (_instance) {
 			_instance->resume();
 		}
-	});
+	},
+			TASK_PRIORITY_URGENT);
 	updateState();
 }
 
@@ -518,7 +595,9 @@ void GodotModule::resume() {
 void GodotModule::updateState() {
 	AndroidPlatformData *data = static_cast<AndroidPlatformData *>(_data);
 	if (data->in_background || data->paused) {
-		// Nothing to do, frameCallback will not do anything if it is paused
+		// Nothing to do, frameCallback will not do anything if it is paused.
+		// Without frames the background lane must not wait for a deadline.
+		data->thread.end_frames();
 	} else {
 		// Register the frame callback again
 		data->thread.enqueue([this]() {
@@ -630,28 +709,20 @@ void GodotModule::updateWindows(bool adding) {
 	}
 }
 
-void GodotModule::runOnGodotThread(std::function<void()> f, bool wait) {
+void GodotModule::runOnGodotThread(std::function<void()> f, bool wait, TaskPriority priority) {
+	AndroidPlatformData *data = static_cast<AndroidPlatformData *>(_data);
 	if (wait) {
-		std::mutex waitMutex;
-		std::condition_variable waitVar;
-		bool ready = false;
-		std::function<void()> runFunc = [&f, &waitMutex, &waitVar, &ready]() {
-			f();
-			std::unique_lock<std::mutex> lock(waitMutex);
-			ready = true;
-			lock.unlock();
-			waitVar.notify_one();
-		};
-		std::unique_lock<std::mutex> lock(waitMutex);
-		AndroidPlatformData *data = static_cast<AndroidPlatformData *>(_data);
-		data->thread.enqueue(runFunc);
-		waitVar.wait(lock, [&ready] { return ready; });
+		data->thread.run_sync(f, priority);
 	} else {
-		AndroidPlatformData *data = static_cast<AndroidPlatformData *>(_data);
-		data->thread.enqueue(f);
+		data->thread.enqueue(std::move(f), priority);
 	}
 }
 
+TaskExecutor *GodotModule::get_thread() {
+	AndroidPlatformData *data = static_cast<AndroidPlatformData *>(_data);
+	return &data->thread;
+}
+
 void GodotModule::iterate() {
 	godot::GodotInstance *instance = nullptr;
 	{
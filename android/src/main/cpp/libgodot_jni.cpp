@@ -30,6 +30,7 @@
 #include <math.h>
 
 #include <GodotModule.h>
+#include <WindowRegistry.h>
 #include <android/input.h>
 #include <android/native_window_jni.h>
 #include <godot_cpp/classes/display_server.hpp>
@@ -146,57 +147,53 @@ JNIEnv *LibGodot::get_jni_env() {
 	return env;
 }
 
-static std::function<void()> createUpdateWindowFunc(std::string p_window_name, int p_width, int p_height, ANativeWindow *p_window_surface, bool p_change_surface) {
-	return [p_window_name, p_width, p_height, p_window_surface, p_change_surface]() {
-		godot::DisplayServerEmbedded *dse = godot::DisplayServerEmbedded::get_singleton();
-		int32_t windowId = -1;
-		if (p_window_name == "") {
-			// Default id
-			windowId = 0;
-		} else {
-			// Find window
-			godot::MainLoop *mainLoop = godot::Engine::get_singleton()->get_main_loop();
-			godot::SceneTree *sceneTree = godot::Object::cast_to<godot::SceneTree>(mainLoop);
-			if (!sceneTree) {
-				LOGE("Unable to get SceneTree from Godot!");
-				return;
-			}
-			godot::Node *node = sceneTree->get_root()->find_child(
-					godot::String::utf8(p_window_name.c_str()), true, false);
-			godot::Window *newWindow = godot::Object::cast_to<godot::Window>(node);
-
-			if (newWindow) {
-				bool change_surface = true;
-				godot::Ref<godot::RenderingNativeSurfaceAndroid> ns = newWindow->get_native_surface();
-				if (ns.is_valid()) {
-					ANativeWindow *current_window = (ANativeWindow *)ns->get_window();
-					if (current_window == p_window_surface) {
-						change_surface = false;
-					}
+static void updateWindowSurface(const std::string &p_window_name, int p_width, int p_height, ANativeWindow *p_window_surface, bool p_change_surface) {
+	godot::DisplayServerEmbedded *dse = godot::DisplayServerEmbedded::get_singleton();
+	int32_t windowId = -1;
+	if (p_window_name == "") {
+		// Default id
+		windowId = 0;
+	} else {
+		// Find window
+		godot::Window *newWindow = WindowRegistry::get_singleton()->find_window(p_window_name);
+
+		if (newWindow) {
+			bool change_surface = true;
+			godot::Ref<godot::RenderingNativeSurfaceAndroid> ns = newWindow->get_native_surface();
+			if (ns.is_valid()) {
+				ANativeWindow *current_window = (ANativeWindow *)ns->get_window();
+				if (current_window == p_window_surface) {
+					change_surface = false;
 				}
+			}
 
-				if (change_surface) {
-					LOGI("Changing surface");
-					godot::Ref<godot::RenderingNativeSurfaceAndroid> androidSurface = godot::RenderingNativeSurfaceAndroid::create(
-							(uint64_t)p_window_surface, p_width, p_height);
-
-					newWindow->set_visible(true);
-					newWindow->set_native_surface(androidSurface);
-				}
+			if (change_surface) {
+				LOGI("Changing surface");
+				godot::Ref<godot::RenderingNativeSurfaceAndroid> androidSurface = godot::RenderingNativeSurfaceAndroid::create(
+						(uint64_t)p_window_surface, p_width, p_height);
 
-				windowId = newWindow->get_window_id();
+				newWindow->set_visible(true);
+				newWindow->set_native_surface(androidSurface);
 			}
+
+			windowId = newWindow->get_window_id();
 		}
-		if (windowId >= 0) {
-			LOGI("Resizing Window: %d %d %d", windowId, p_width, p_height);
-			dse->resize_window(godot::Vector2i(p_width, p_height), windowId);
-			{
-				std::lock_guard<std::recursive_mutex> lock(windowMapMutex);
-				if (windowId > 0 && windowMap.contains(p_window_name)) {
-					windowMap[p_window_name].id = windowId;
-				}
+	}
+	if (windowId >= 0) {
+		LOGI("Resizing Window: %d %d %d", windowId, p_width, p_height);
+		dse->resize_window(godot::Vector2i(p_width, p_height), windowId);
+		{
+			std::lock_guard<std::recursive_mutex> lock(windowMapMutex);
+			if (windowId > 0 && windowMap.contains(p_window_name)) {
+				windowMap[p_window_name].id = windowId;
 			}
 		}
+	}
+}
+
+static std::function<void()> createUpdateWindowFunc(std::string p_window_name, int p_width, int p_height, ANativeWindow *p_window_surface, bool p_change_surface) {
+	return [p_window_name, p_width, p_height, p_window_surface, p_change_surface]() {
+		updateWindowSurface(p_window_name, p_width, p_height, p_window_surface, p_change_surface);
 	};
 }
 
@@ -232,7 +229,10 @@ void LibGodot::updateWindowNative(JNIEnv *env, jstring p_name, jobject p_surface
 	}
 	godot::GodotInstance *instance = GodotModule::get_singleton()->get_instance();
 	if (instance && instance->is_started()) {
-		GodotModule::get_singleton()->runOnGodotThread(createUpdateWindowFunc(windowName, p_width, p_height, windowSurface, changeSurface), true);
+		// Waits for the update, so the arguments can be passed by reference.
+		GodotModule::get_singleton()->runOnGodotThreadSync([&]() {
+			updateWindowSurface(windowName, p_width, p_height, windowSurface, changeSurface);
+		});
 	}
 }
 
@@ -264,16 +264,7 @@ void LibGodot::removeWindowNative(JNIEnv *env, jstring p_name) {
 				godot::DisplayServerEmbedded *dse = godot::DisplayServerEmbedded::get_singleton();
 				{
 					// Find window
-					godot::MainLoop *mainLoop = godot::Engine::get_singleton()->get_main_loop();
-					godot::SceneTree *sceneTree = godot::Object::cast_to<godot::SceneTree>(
-							mainLoop);
-					if (!sceneTree) {
-						LOGE("Unable to get SceneTree from Godot!");
-						return;
-					}
-					godot::Node *node = sceneTree->get_root()->find_child(
-							godot::String::utf8(windowName.c_str()), true, false);
-					godot::Window *window = godot::Object::cast_to<godot::Window>(node);
+					godot::Window *window = WindowRegistry::get_singleton()->find_window(windowName);
 
 					if (window) {
 						godot::Ref<godot::RenderingNativeSurface> nativeSurface;
@@ -281,7 +272,8 @@ void LibGodot::removeWindowNative(JNIEnv *env, jstring p_name) {
 					}
 					ANativeWindow_release(windowSurface);
 				}
-			});
+			},
+					false, TASK_PRIORITY_URGENT);
 		}
 		windowMap.erase(windowName);
 	}
@@ -293,7 +285,7 @@ void LibGodot::updateWindow(std::string windowName) {
 		godot::GodotInstance *instance = GodotModule::get_singleton()->get_instance();
 		WindowData &data = windowMap[windowName];
 		if (instance && instance->is_started()) {
-			GodotModule::get_singleton()->runOnGodotThread(createUpdateWindowFunc(windowName, data.width, data.height, data.surface, windowName != ""));
+			GodotModule::get_singleton()->runOnGodotThread(createUpdateWindowFunc(windowName, data.width, data.height, data.surface, windowName != ""), false, TASK_PRIORITY_URGENT);
 		}
 	}
 }
@@ -307,7 +299,8 @@ void LibGodot::updateWindows() {
 			WindowData &data = item.second;
 			GodotModule::get_singleton()->runOnGodotThread(
 					createUpdateWindowFunc(windowName, data.width, data.height, data.surface,
-							windowName != ""));
+							windowName != ""),
+					false, TASK_PRIORITY_URGENT);
 		}
 	}
 }
@@ -46,7 +46,8 @@ import com.facebook.react.uimanager.ViewManager;
 
 public class GodotPackage extends TurboReactPackage {
 	static {
-		System.loadLibrary("rtngodot");
+		// A build with libgodot linked in statically replaces libgodot_android.so.
+		System.loadLibrary(BuildConfig.LIBGODOT_STATIC ? "godot_android" : "rtngodot");
 	}
 
 	private static final String TAG = "GodotPackage";
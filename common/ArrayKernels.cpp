@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*  ArrayKernels.cpp                                                      */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ArrayKernels.h"
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ARRAY_KERNELS_NEON
+#elif defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#ifdef __AVX__
+#define ARRAY_KERNELS_AVX
+#endif
+#define ARRAY_KERNELS_SSE2
+#endif
+
+void ArrayKernels::f64_to_f32(const double *p_src, float *r_dst, size_t p_count) {
+	size_t i = 0;
+#if defined(ARRAY_KERNELS_NEON)
+	for (; i + 4 <= p_count; i += 4) {
+		float32x2_t lo = vcvt_f32_f64(vld1q_f64(p_src + i));
+		float32x2_t hi = vcvt_f32_f64(vld1q_f64(p_src + i + 2));
+		vst1q_f32(r_dst + i, vcombine_f32(lo, hi));
+	}
+#elif defined(ARRAY_KERNELS_AVX)
+	for (; i + 8 <= p_count; i += 8) {
+		__m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(p_src + i));
+		__m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(p_src + i + 4));
+		_mm_storeu_ps(r_dst + i, lo);
+		_mm_storeu_ps(r_dst + i + 4, hi);
+	}
+#elif defined(ARRAY_KERNELS_SSE2)
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(p_src + i));
+		__m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(p_src + i + 2));
+		_mm_storeu_ps(r_dst + i, _mm_movelh_ps(lo, hi));
+	}
+#endif
+	for (; i < p_count; i++) {
+		r_dst[i] = (float)p_src[i];
+	}
+}
+
+void ArrayKernels::f32_to_f64(const float *p_src, double *r_dst, size_t p_count) {
+	size_t i = 0;
+#if defined(ARRAY_KERNELS_NEON)
+	for (; i + 4 <= p_count; i += 4) {
+		float32x4_t v = vld1q_f32(p_src + i);
+		vst1q_f64(r_dst + i, vcvt_f64_f32(vget_low_f32(v)));
+		vst1q_f64(r_dst + i + 2, vcvt_high_f64_f32(v));
+	}
+#elif defined(ARRAY_KERNELS_AVX)
+	for (; i + 4 <= p_count; i += 4) {
+		_mm256_storeu_pd(r_dst + i, _mm256_cvtps_pd(_mm_loadu_ps(p_src + i)));
+	}
+#elif defined(ARRAY_KERNELS_SSE2)
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 v = _mm_loadu_ps(p_src + i);
+		_mm_storeu_pd(r_dst + i, _mm_cvtps_pd(v));
+		_mm_storeu_pd(r_dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+	}
+#endif
+	for (; i < p_count; i++) {
+		r_dst[i] = (double)p_src[i];
+	}
+}
+
+void ArrayKernels::f64_to_f32_strided(const double *p_src, size_t p_src_stride, float *r_dst, size_t p_dst_stride, size_t p_elements, size_t p_components) {
+	if (p_src_stride == p_components && p_dst_stride == p_components) {
+		f64_to_f32(p_src, r_dst, p_elements * p_components);
+		return;
+	}
+	for (size_t e = 0; e < p_elements; e++) {
+		const double *src = p_src + e * p_src_stride;
+		float *dst = r_dst + e * p_dst_stride;
+		for (size_t c = 0; c < p_components; c++) {
+			dst[c] = (float)src[c];
+		}
+	}
+}
+
+void ArrayKernels::f32_to_f64_strided(const float *p_src, size_t p_src_stride, double *r_dst, size_t p_dst_stride, size_t p_elements, size_t p_components) {
+	if (p_src_stride == p_components && p_dst_stride == p_components) {
+		f32_to_f64(p_src, r_dst, p_elements * p_components);
+		return;
+	}
+	for (size_t e = 0; e < p_elements; e++) {
+		const float *src = p_src + e * p_src_stride;
+		double *dst = r_dst + e * p_dst_stride;
+		for (size_t c = 0; c < p_components; c++) {
+			dst[c] = (double)src[c];
+		}
+	}
+}
+
+const char *ArrayKernels::get_backend() {
+#if defined(ARRAY_KERNELS_NEON)
+	return "neon";
+#elif defined(ARRAY_KERNELS_AVX)
+	return "avx";
+#elif defined(ARRAY_KERNELS_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+bool ArrayKernels::to_index(double p_value, size_t &r_index) {
+	// 2^53, the largest integer range JS numbers represent exactly.
+	const double max_index = 9007199254740992.0;
+	if (!std::isfinite(p_value) || p_value < 0 || p_value > max_index || std::floor(p_value) != p_value) {
+		return false;
+	}
+	r_index = (size_t)p_value;
+	return true;
+}
+
+bool ArrayKernels::get_extent(size_t p_offset, size_t p_stride, size_t p_elements, size_t p_components, size_t &r_extent) {
+	if (p_elements == 0) {
+		r_extent = p_offset;
+		return true;
+	}
+	size_t last = p_elements - 1;
+	if (p_components > SIZE_MAX - p_offset) {
+		return false;
+	}
+	if (p_stride != 0 && last > (SIZE_MAX - p_offset - p_components) / p_stride) {
+		return false;
+	}
+	r_extent = p_offset + last * p_stride + p_components;
+	return true;
+}
+
+bool ArrayKernels::is_view_in_bounds(size_t p_byte_offset, size_t p_count, size_t p_element_size, size_t p_buffer_size) {
+	if (p_element_size == 0 || p_byte_offset % p_element_size != 0 || p_byte_offset > p_buffer_size) {
+		return false;
+	}
+	return p_count <= (p_buffer_size - p_byte_offset) / p_element_size;
+}
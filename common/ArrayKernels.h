@@ -0,0 +1,61 @@
+/**************************************************************************/
+/*  ArrayKernels.h                                                        */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+// Bulk conversions between JS numbers (float64) and the float32 storage of
+// Godot's packed arrays. Uses NEON on arm64, SSE2 / AVX on x86_64, and a
+// scalar loop everywhere else.
+class ArrayKernels {
+public:
+	static void f64_to_f32(const double *p_src, float *r_dst, size_t p_count);
+	static void f32_to_f64(const float *p_src, double *r_dst, size_t p_count);
+
+	// Converts p_elements elements of p_components values each. Strides are
+	// the distance between elements in values, so interleaved data, e.g.
+	// positions and normals, can be read or written in place.
+	static void f64_to_f32_strided(const double *p_src, size_t p_src_stride, float *r_dst, size_t p_dst_stride, size_t p_elements, size_t p_components);
+	static void f32_to_f64_strided(const float *p_src, size_t p_src_stride, double *r_dst, size_t p_dst_stride, size_t p_elements, size_t p_components);
+
+	// Name of the instruction set used, for stats and logs.
+	static const char *get_backend();
+
+	// Range checks for views and layouts that come from JS, none of their
+	// values can be trusted.
+
+	// Converts a JS number to an index or length. Fails for negative,
+	// fractional and non-finite numbers, and for numbers above 2^53.
+	static bool to_index(double p_value, size_t &r_index);
+
+	// Number of values spanned by p_elements elements of p_components values,
+	// p_stride values apart, starting at p_offset. Fails on overflow.
+	static bool get_extent(size_t p_offset, size_t p_stride, size_t p_elements, size_t p_components, size_t &r_extent);
+
+	// Whether p_count elements of p_element_size bytes at p_byte_offset lie
+	// inside a buffer of p_buffer_size bytes, aligned to the element size.
+	static bool is_view_in_bounds(size_t p_byte_offset, size_t p_count, size_t p_element_size, size_t p_buffer_size);
+};
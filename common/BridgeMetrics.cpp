@@ -0,0 +1,135 @@
+/**************************************************************************/
+/*  BridgeMetrics.cpp                                                     */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "BridgeMetrics.h"
+
+#include <bit>
+
+std::atomic<bool> BridgeMetrics::_enabled = false;
+BridgeMetrics::Histogram BridgeMetrics::_histograms[BRIDGE_METRIC_MAX];
+
+int BridgeMetrics::get_bucket(uint64_t p_ns) {
+	if (p_ns < SUB_BUCKETS) {
+		return (int)p_ns;
+	}
+	// The highest bit selects the power of two, the next three bits the sub bucket.
+	int msb = 63 - std::countl_zero(p_ns);
+	int sub = (int)((p_ns >> (msb - 3)) & (SUB_BUCKETS - 1));
+	return (msb - 2) * SUB_BUCKETS + sub;
+}
+
+uint64_t BridgeMetrics::get_bucket_upper_bound(int p_bucket) {
+	if (p_bucket < SUB_BUCKETS) {
+		return (uint64_t)p_bucket;
+	}
+	int msb = p_bucket / SUB_BUCKETS + 2;
+	uint64_t sub = (uint64_t)(p_bucket % SUB_BUCKETS);
+	uint64_t lower = (1ull << msb) | (sub << (msb - 3));
+	return lower + (1ull << (msb - 3)) - 1;
+}
+
+void BridgeMetrics::set_enabled(bool p_enabled) {
+	_enabled.store(p_enabled, std::memory_order_relaxed);
+}
+
+void BridgeMetrics::record(BridgeMetric p_metric, uint64_t p_ns) {
+	Histogram &h = _histograms[p_metric];
+	h.total_ns.fetch_add(p_ns, std::memory_order_relaxed);
+	h.buckets[get_bucket(p_ns)].fetch_add(1, std::memory_order_relaxed);
+	uint64_t max = h.max_ns.load(std::memory_order_relaxed);
+	while (p_ns > max && !h.max_ns.compare_exchange_weak(max, p_ns, std::memory_order_relaxed)) {
+	}
+}
+
+BridgeMetricStats BridgeMetrics::get_stats(BridgeMetric p_metric) {
+	Histogram &h = _histograms[p_metric];
+	BridgeMetricStats stats;
+	stats.total_ns = h.total_ns.load(std::memory_order_relaxed);
+	stats.max_ns = h.max_ns.load(std::memory_order_relaxed);
+
+	// Records running concurrently can make count and total_ns differ slightly.
+	uint64_t counts[BUCKETS];
+	uint64_t total = 0;
+	for (int i = 0; i < BUCKETS; i++) {
+		counts[i] = h.buckets[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+	stats.count = total;
+	uint64_t p50 = (total * 50 + 99) / 100;
+	uint64_t p99 = (total * 99 + 99) / 100;
+	uint64_t seen = 0;
+	bool found_p50 = false;
+	for (int i = 0; i < BUCKETS && seen < p99; i++) {
+		seen += counts[i];
+		if (!found_p50 && seen >= p50 && counts[i]) {
+			// The bucket of 0 ns has a bound of 0, so p50_ns cannot mark it as found.
+			stats.p50_ns = get_bucket_upper_bound(i);
+			found_p50 = true;
+		}
+		if (seen >= p99) {
+			stats.p99_ns = get_bucket_upper_bound(i);
+		}
+	}
+	if (stats.p50_ns > stats.max_ns) {
+		stats.p50_ns = stats.max_ns;
+	}
+	if (stats.p99_ns > stats.max_ns) {
+		stats.p99_ns = stats.max_ns;
+	}
+	return stats;
+}
+
+const char *BridgeMetrics::get_name(BridgeMetric p_metric) {
+	switch (p_metric) {
+		case BRIDGE_METHOD_CALL:
+			return "methodCall";
+		case BRIDGE_STATIC_CALL:
+			return "staticCall";
+		case BRIDGE_JS_CALLABLE:
+			return "jsCallable";
+		case BRIDGE_RUN_ON_GODOT_THREAD:
+			return "runOnGodotThread";
+		case BRIDGE_TYPE_LOOKUP:
+			return "typeLookup";
+		case BRIDGE_TO_VARIANT:
+			return "toVariant";
+		case BRIDGE_FROM_VARIANT:
+			return "fromVariant";
+		case BRIDGE_WINDOW_UPDATE:
+			return "windowUpdate";
+		default:
+			return "unknown";
+	}
+}
+
+void BridgeMetrics::reset() {
+	for (Histogram &h : _histograms) {
+		h.total_ns.store(0, std::memory_order_relaxed);
+		h.max_ns.store(0, std::memory_order_relaxed);
+		for (std::atomic<uint64_t> &b : h.buckets) {
+			b.store(0, std::memory_order_relaxed);
+		}
+	}
+}
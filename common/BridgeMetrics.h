@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*  BridgeMetrics.h                                                       */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+enum BridgeMetric {
+	BRIDGE_METHOD_CALL, // JS calling a Godot method, including argument and result conversion.
+	BRIDGE_STATIC_CALL, // JS calling a static method of a Godot class.
+	BRIDGE_JS_CALLABLE, // Godot calling a JS function, including the thread hop.
+	BRIDGE_RUN_ON_GODOT_THREAD, // runOnGodotThread() until its Promise is resolved on the JS thread.
+	BRIDGE_TYPE_LOOKUP, // Resolving a class, singleton or builtin type on the API object.
+	BRIDGE_TO_VARIANT, // One JS value converted to a Variant.
+	BRIDGE_FROM_VARIANT, // One Variant converted to a JS value.
+	BRIDGE_WINDOW_UPDATE, // RTNGodot.updateWindow() round trip.
+	BRIDGE_METRIC_MAX,
+};
+
+struct BridgeMetricStats {
+	uint64_t count = 0;
+	uint64_t total_ns = 0;
+	uint64_t max_ns = 0;
+	uint64_t p50_ns = 0;
+	uint64_t p99_ns = 0;
+};
+
+// Latency histograms of the bridge paths, off by default. Recording is
+// lock free, percentiles are accurate to 1/8 of their power of two.
+class BridgeMetrics {
+	static constexpr int SUB_BUCKETS = 8;
+	static constexpr int BUCKETS = 64 * SUB_BUCKETS;
+
+	struct Histogram {
+		std::atomic<uint64_t> total_ns = 0;
+		std::atomic<uint64_t> max_ns = 0;
+		std::atomic<uint64_t> buckets[BUCKETS] = {};
+	};
+
+	static std::atomic<bool> _enabled;
+	static Histogram _histograms[BRIDGE_METRIC_MAX];
+
+	static int get_bucket(uint64_t p_ns);
+	static uint64_t get_bucket_upper_bound(int p_bucket);
+
+public:
+	static bool is_enabled() {
+		return _enabled.load(std::memory_order_relaxed);
+	}
+
+	static void set_enabled(bool p_enabled);
+
+	static void record(BridgeMetric p_metric, uint64_t p_ns);
+
+	static BridgeMetricStats get_stats(BridgeMetric p_metric);
+
+	static const char *get_name(BridgeMetric p_metric);
+
+	static void reset();
+
+	static uint64_t now_ns() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Records the time until the end of the scope, when metrics are enabled.
+	class Scope {
+		BridgeMetric _metric;
+		uint64_t _start;
+
+	public:
+		Scope(BridgeMetric p_metric) :
+				_metric(p_metric), _start(is_enabled() ? now_ns() : 0) {}
+
+		~Scope() {
+			if (_start) {
+				record(_metric, now_ns() - _start);
+			}
+		}
+	};
+};
@@ -0,0 +1,105 @@
+/**************************************************************************/
+/*  CallArena.cpp                                                         */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "CallArena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+std::atomic<uint64_t> CallArena::_heap_allocations = 0;
+std::atomic<uint64_t> CallArena::_high_water = 0;
+
+CallArena::Scope::Scope() :
+		_arena(CallArena::get_thread_arena()), _block(_arena._current), _used(_arena._current->used) {}
+
+CallArena::Scope::~Scope() {
+	_arena.release((Block *)_block, _used);
+}
+
+CallArena &CallArena::get_thread_arena() {
+	static thread_local CallArena arena;
+	return arena;
+}
+
+CallArena::Stats CallArena::get_stats() {
+	Stats stats;
+	stats.heap_allocations = _heap_allocations.load(std::memory_order_relaxed);
+	stats.high_water = _high_water.load(std::memory_order_relaxed);
+	return stats;
+}
+
+CallArena::~CallArena() {
+	release(&_inline_block, 0);
+	free(_spare);
+}
+
+void *CallArena::allocate_bytes(size_t p_size, size_t p_align) {
+	size_t offset = (_current->used + p_align - 1) & ~(p_align - 1);
+	if (offset + p_size > _current->capacity) {
+		size_t capacity = std::max(BLOCK_SIZE, p_size + p_align);
+		Block *block = nullptr;
+		if (_spare && _spare->capacity >= capacity) {
+			block = _spare;
+			_spare = nullptr;
+		} else {
+			block = (Block *)malloc(sizeof(Block) + capacity);
+			if (!block) {
+				throw std::bad_alloc();
+			}
+			block->capacity = capacity;
+			block->data = (uint8_t *)(block + 1);
+			_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+		}
+		block->prev = _current;
+		block->used = 0;
+		_current = block;
+		offset = ((uintptr_t)block->data % p_align) ? p_align - ((uintptr_t)block->data % p_align) : 0;
+	}
+	void *ptr = _current->data + offset;
+	_total_used += offset + p_size - _current->used;
+	_current->used = offset + p_size;
+
+	uint64_t high_water = _high_water.load(std::memory_order_relaxed);
+	while (_total_used > high_water && !_high_water.compare_exchange_weak(high_water, _total_used, std::memory_order_relaxed)) {
+	}
+	return ptr;
+}
+
+void CallArena::release(Block *p_block, size_t p_used) {
+	while (_current != p_block) {
+		Block *block = _current;
+		_current = block->prev;
+		_total_used -= block->used;
+		// Keep the largest block around for the next overflow.
+		if (!_spare || _spare->capacity < block->capacity) {
+			free(_spare);
+			_spare = block;
+		} else {
+			free(block);
+		}
+	}
+	_total_used -= _current->used - p_used;
+	_current->used = p_used;
+}
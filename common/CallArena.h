@@ -0,0 +1,134 @@
+/**************************************************************************/
+/*  CallArena.h                                                           */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+// Per-thread bump allocator for the argument arrays of a bridge call.
+// Memory is handed out in stack order and released when the enclosing
+// Scope ends, so nested calls (e.g. Godot calling back into JS while a JS
+// call into Godot is running) can use it as well. The first INLINE_SIZE
+// bytes of each thread need no heap allocation.
+class CallArena {
+public:
+	static constexpr size_t INLINE_SIZE = 2048;
+	static constexpr size_t BLOCK_SIZE = 16384;
+
+	struct Stats {
+		uint64_t heap_allocations = 0;
+		uint64_t high_water = 0;
+	};
+
+	class Scope {
+		CallArena &_arena;
+		void *_block;
+		size_t _used;
+
+	public:
+		Scope();
+		~Scope();
+
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+		CallArena &get_arena() { return _arena; }
+	};
+
+	// Uninitialized memory for p_count objects of type T.
+	template <typename T>
+	T *allocate(size_t p_count) {
+		return (T *)allocate_bytes(p_count * sizeof(T), alignof(T));
+	}
+
+	static CallArena &get_thread_arena();
+
+	// Summed over all threads.
+	static Stats get_stats();
+
+	~CallArena();
+
+private:
+	struct Block {
+		Block *prev;
+		size_t capacity;
+		size_t used;
+		uint8_t *data;
+	};
+
+	alignas(std::max_align_t) uint8_t _inline[INLINE_SIZE];
+	Block _inline_block = { nullptr, INLINE_SIZE, 0, _inline };
+	Block *_current = &_inline_block;
+	Block *_spare = nullptr;
+	size_t _total_used = 0;
+
+	static std::atomic<uint64_t> _heap_allocations;
+	static std::atomic<uint64_t> _high_water;
+
+	CallArena() {}
+
+	void *allocate_bytes(size_t p_size, size_t p_align);
+	void release(Block *p_block, size_t p_used);
+};
+
+// Fixed capacity array in the current CallArena scope. Destroys its
+// elements, the memory is released with the scope.
+template <typename T>
+class ArenaArray {
+	T *_data;
+	size_t _capacity;
+	size_t _size = 0;
+
+public:
+	ArenaArray(CallArena::Scope &p_scope, size_t p_capacity) :
+			_data(p_scope.get_arena().allocate<T>(p_capacity)), _capacity(p_capacity) {}
+
+	~ArenaArray() {
+		while (_size > 0) {
+			_data[--_size].~T();
+		}
+	}
+
+	ArenaArray(const ArenaArray &) = delete;
+	ArenaArray &operator=(const ArenaArray &) = delete;
+
+	template <typename... Args>
+	T &emplace_back(Args &&...p_args) {
+		// Callers size the array up front, the capacity is never exceeded.
+		T *slot = new (_data + _size) T(std::forward<Args>(p_args)...);
+		_size++;
+		return *slot;
+	}
+
+	T *data() { return _data; }
+	const T *data() const { return _data; }
+	size_t size() const { return _size; }
+	T &operator[](size_t p_index) { return _data[p_index]; }
+	const T &operator[](size_t p_index) const { return _data[p_index]; }
+};
@@ -0,0 +1,67 @@
+/**************************************************************************/
+/*  FileRoute.cpp                                                         */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "FileRoute.h"
+
+static bool has_prefix(const std::string &p_path, const char *p_prefix) {
+	return p_path.rfind(p_prefix, 0) == 0;
+}
+
+FileRoute::Route FileRoute::get_android_file_route(const std::string &p_path) {
+	// uid:// paths are resolved to res:// paths.
+	if (has_prefix(p_path, "res://") || has_prefix(p_path, "uid://") || has_prefix(p_path, "user://")) {
+		return ROUTE_NATIVE;
+	}
+	return ROUTE_JAVA;
+}
+
+FileRoute::Route FileRoute::get_android_dir_route(const std::string &p_path) {
+	if (has_prefix(p_path, "user://")) {
+		return ROUTE_NATIVE;
+	}
+	return ROUTE_JAVA;
+}
+
+FileRoute::Route FileRoute::get_file_route(const std::string &p_path) {
+#ifdef ANDROID
+	return get_android_file_route(p_path);
+#else
+	(void)p_path;
+	return ROUTE_NATIVE;
+#endif
+}
+
+FileRoute::Route FileRoute::get_dir_route(const std::string &p_path) {
+#ifdef ANDROID
+	return get_android_dir_route(p_path);
+#else
+	(void)p_path;
+	return ROUTE_NATIVE;
+#endif
+}
+
+const char *FileRoute::get_name(Route p_route) {
+	return p_route == ROUTE_JAVA ? "java" : "native";
+}
@@ -0,0 +1,55 @@
+/**************************************************************************/
+/*  FileRoute.h                                                           */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <string>
+
+// How Godot's Android build reaches a path. res:// files come from the APK
+// assets through the AAssetManager, user:// files and directories through
+// POSIX I/O. Other filesystem paths, and directory listings of res://, go
+// through the Java FileAccessHandler / DirAccessHandler with one JNI call
+// per operation. With a main pack, res:// is read from the pack file, which
+// takes the route of the pack's own path. Other platforms only have the
+// native route.
+class FileRoute {
+public:
+	enum Route {
+		ROUTE_NATIVE,
+		ROUTE_JAVA,
+	};
+
+	// Route of opening and reading the file p_path on Android.
+	static Route get_android_file_route(const std::string &p_path);
+
+	// Route of listing the directory p_path on Android.
+	static Route get_android_dir_route(const std::string &p_path);
+
+	// Routes on the current platform.
+	static Route get_file_route(const std::string &p_path);
+	static Route get_dir_route(const std::string &p_path);
+
+	static const char *get_name(Route p_route);
+};
@@ -0,0 +1,286 @@
+/**************************************************************************/
+/*  GodotEventStream.cpp                                                  */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "GodotEventStream.h"
+#define LOG_TAG "GodotEventStream"
+#include "godot-log.h"
+
+#include "GodotModule.h"
+#include "VariantCodec.h"
+#include <godot_cpp/core/object.hpp>
+
+#include <unordered_set>
+
+// Payload bytes reserved per event up front, slots grow for larger arguments.
+static const size_t RESERVED_PAYLOAD = 64;
+
+// Streams that are alive, for close_all().
+static std::mutex streams_mutex;
+static std::unordered_set<GodotEventStream *> streams;
+
+GodotEventStream::GodotEventStream(uint32_t p_capacity, OverflowPolicy p_policy, uint32_t p_block_timeout_ms) :
+		_ring(p_capacity > 0 ? p_capacity : 1), _policy(p_policy), _block_timeout(p_block_timeout_ms), _drain_thread(std::this_thread::get_id()) {
+	_stats.capacity = _ring.size();
+	for (Slot &slot : _ring) {
+		slot.event.payload.reserve(RESERVED_PAYLOAD);
+	}
+	if (_policy == OVERFLOW_COALESCE) {
+		_pending_keys.reserve(_ring.size());
+	}
+	std::lock_guard lock(streams_mutex);
+	streams.insert(this);
+}
+
+GodotEventStream::~GodotEventStream() {
+	// close() keeps the stream alive until the connections are released on
+	// the Godot thread, and close_all() releases them before the engine is
+	// unloaded, so none are left here.
+	std::lock_guard lock(streams_mutex);
+	streams.erase(this);
+}
+
+bool GodotEventStream::parse_policy(const std::string &p_name, OverflowPolicy &r_policy) {
+	if (p_name == "dropOldest") {
+		r_policy = OVERFLOW_DROP_OLDEST;
+	} else if (p_name == "coalesce") {
+		r_policy = OVERFLOW_COALESCE;
+	} else if (p_name == "block") {
+		r_policy = OVERFLOW_BLOCK;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void GodotEventStream::release(Slot &p_slot) {
+	// Called with _mutex held. clear() keeps the capacity of the payload.
+	if (_policy == OVERFLOW_COALESCE) {
+		_pending_keys.erase(Key{ p_slot.event.signal_id, p_slot.event.source });
+	}
+	p_slot.event.payload.clear();
+	p_slot.live = false;
+	_live--;
+}
+
+int GodotEventStream::connect(godot::Object *p_object, const std::string &p_signal) {
+	if (!p_object) {
+		return -1;
+	}
+	godot::StringName signal(p_signal.c_str());
+	if (!p_object->has_signal(signal)) {
+		LOGE("Object has no signal: %s", p_signal.c_str());
+		return -1;
+	}
+
+	uint32_t signalId = 0;
+	{
+		std::lock_guard lock(_mutex);
+		if (_closed) {
+			return -1;
+		}
+		signalId = _signal_names.size();
+		_signal_names.push_back(p_signal);
+	}
+
+	uint64_t source = p_object->get_instance_id();
+	// The stream is owned by the JS object, the callable only holds a weak
+	// reference to not keep it alive from the Godot side.
+	std::weak_ptr<GodotEventStream> weakSelf = weak_from_this();
+	godot::Callable callable = GodotModule::get_singleton()->create_callable([weakSelf, signalId, source](const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) {
+		std::shared_ptr<GodotEventStream> self = weakSelf.lock();
+		if (self) {
+			self->push(signalId, source, p_arguments, p_argcount);
+		}
+	});
+	godot::Error err = (godot::Error)p_object->connect(signal, callable);
+	if (err != godot::OK) {
+		LOGE("Unable to connect to signal %s: %d", p_signal.c_str(), (int)err);
+		return -1;
+	}
+
+	std::lock_guard lock(_mutex);
+	_connections.push_back(Connection{ source, signal, callable });
+	return signalId;
+}
+
+void GodotEventStream::disconnect_all() {
+	// Called on the Godot thread.
+	std::vector<Connection> connections;
+	{
+		std::lock_guard lock(_mutex);
+		connections.swap(_connections);
+	}
+	for (const Connection &c : connections) {
+		godot::Object *object = godot::ObjectDB::get_instance(c.source);
+		if (object && object->is_connected(c.signal, c.callable)) {
+			object->disconnect(c.signal, c.callable);
+		}
+	}
+}
+
+void GodotEventStream::close() {
+	{
+		std::lock_guard lock(_mutex);
+		if (_closed) {
+			return;
+		}
+		_closed = true;
+	}
+	_space_var.notify_all();
+
+	// May be called from the JS thread or a GC thread. Without an instance
+	// close_all() has already released the connections.
+	GodotModule *module = GodotModule::get_singleton();
+	if (!module->get_instance()) {
+		return;
+	}
+	std::shared_ptr<GodotEventStream> self = shared_from_this();
+	module->runOnGodotThread([self]() {
+		if (GodotModule::get_singleton()->get_instance()) {
+			self->disconnect_all();
+		}
+	}, false, TASK_PRIORITY_URGENT);
+}
+
+void GodotEventStream::close_all() {
+	std::lock_guard lock(streams_mutex);
+	for (GodotEventStream *stream : streams) {
+		{
+			std::lock_guard streamLock(stream->_mutex);
+			stream->_closed = true;
+		}
+		stream->_space_var.notify_all();
+		stream->disconnect_all();
+	}
+}
+
+void GodotEventStream::make_room() {
+	// Called with _mutex held and a full ring. Slots freed by coalescing
+	// are reused first, only then the oldest pending event is dropped.
+	bool freed = false;
+	while (_count > 0 && !_ring[_head].live) {
+		_head = (_head + 1) % _ring.size();
+		_count--;
+		freed = true;
+	}
+	if (freed || _count == 0) {
+		return;
+	}
+	release(_ring[_head]);
+	_stats.dropped++;
+	_head = (_head + 1) % _ring.size();
+	_count--;
+}
+
+void GodotEventStream::push(uint32_t p_signal_id, uint64_t p_source, const godot::Variant **p_arguments, int p_argcount) {
+	Key key{ p_signal_id, p_source };
+
+	// Encoded before locking, so the consumer is not held up by it.
+	static thread_local std::vector<uint8_t> payload;
+	payload.clear();
+	for (int i = 0; i < p_argcount; ++i) {
+		VariantCodec::encode(*p_arguments[i], payload);
+	}
+
+	std::unique_lock lock(_mutex);
+	if (_closed) {
+		return;
+	}
+	_stats.pushed++;
+
+	if (_policy == OVERFLOW_COALESCE) {
+		auto it = _pending_keys.find(key);
+		if (it != _pending_keys.end()) {
+			// Remove the pending event, the new one goes to the end to keep the order of emissions.
+			release(_ring[it->second]);
+			_stats.coalesced++;
+		}
+	}
+
+	if (_count == _ring.size()) {
+		// When the consumer drains on this thread (e.g. a worklet on the
+		// Godot thread), waiting could only time out, drop the oldest instead.
+		if (_policy == OVERFLOW_BLOCK && _drain_thread.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+			_stats.blocked++;
+			_space_var.wait_for(lock, _block_timeout, [this]() { return _count < _ring.size() || _closed; });
+			if (_closed) {
+				return;
+			}
+		}
+		if (_count == _ring.size()) {
+			make_room();
+		}
+	}
+
+	size_t index = (_head + _count) % _ring.size();
+	Slot &slot = _ring[index];
+	slot.event.signal_id = p_signal_id;
+	slot.event.source = p_source;
+	slot.event.argcount = p_argcount;
+	slot.event.payload.assign(payload.begin(), payload.end());
+	slot.live = true;
+	_count++;
+	_live++;
+	if (_policy == OVERFLOW_COALESCE) {
+		_pending_keys[key] = index;
+	}
+}
+
+size_t GodotEventStream::drain(std::vector<Event> &r_events, size_t p_max) {
+	size_t drained = 0;
+	_drain_thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+	{
+		std::lock_guard lock(_mutex);
+		while (_count > 0 && drained < p_max) {
+			Slot &slot = _ring[_head];
+			if (slot.live) {
+				r_events.push_back(slot.event);
+				release(slot);
+				drained++;
+			}
+			_head = (_head + 1) % _ring.size();
+			_count--;
+		}
+	}
+	_space_var.notify_all();
+	return drained;
+}
+
+std::string GodotEventStream::get_signal_name(uint32_t p_signal_id) {
+	std::lock_guard lock(_mutex);
+	return _signal_names[p_signal_id];
+}
+
+void GodotEventStream::add_invalid(uint64_t p_count) {
+	std::lock_guard lock(_mutex);
+	_stats.invalid += p_count;
+}
+
+GodotEventStream::Stats GodotEventStream::get_stats() {
+	std::lock_guard lock(_mutex);
+	Stats stats = _stats;
+	stats.pending = _live;
+	return stats;
+}
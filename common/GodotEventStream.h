@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*  GodotEventStream.h                                                    */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+#include <godot_cpp/variant/variant.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Bounded queue of Godot signal emissions, drained by JS in batches.
+//
+// Each connected signal gets a small id, an event is stored as the signal
+// id, the ObjectID of the emitter and the arguments encoded with
+// VariantCodec. The ring is allocated once and each slot keeps its payload
+// storage, so pushing an event only copies the encoded arguments into a free
+// slot and no Variant outlives the emission. What happens when the ring is
+// full is decided by the OverflowPolicy.
+//
+// Connecting and disconnecting happen on the Godot thread. A stream can
+// outlive the Godot instance in JS, close_all() drops the connections of all
+// streams while the engine is still loaded.
+class GodotEventStream : public std::enable_shared_from_this<GodotEventStream> {
+public:
+	// Largest ring a stream can be created with.
+	static const uint32_t MAX_CAPACITY = 65536;
+
+	enum OverflowPolicy {
+		OVERFLOW_DROP_OLDEST, // Replace the oldest pending event.
+		OVERFLOW_COALESCE, // Keep only the latest pending event per signal and emitter, drop the oldest if still full.
+		OVERFLOW_BLOCK, // Wait for JS to drain, up to the block timeout, then drop the oldest. Drops right away when JS drains on the emitting thread.
+	};
+
+	struct Event {
+		uint32_t signal_id = 0;
+		uint64_t source = 0;
+		uint32_t argcount = 0;
+		std::vector<uint8_t> payload; // The arguments, encoded one after another.
+	};
+
+	struct Stats {
+		uint64_t pushed = 0;
+		uint64_t dropped = 0;
+		uint64_t coalesced = 0;
+		uint64_t blocked = 0;
+		uint64_t invalid = 0;
+		uint32_t pending = 0;
+		uint32_t capacity = 0;
+	};
+
+private:
+	struct Slot {
+		Event event; // payload keeps its capacity between events.
+		bool live = false;
+	};
+
+	// Coalescing identity of an event, the signal and its emitter.
+	struct Key {
+		uint32_t signal_id;
+		uint64_t source;
+
+		bool operator==(const Key &p_other) const {
+			return signal_id == p_other.signal_id && source == p_other.source;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key &p_key) const {
+			return std::hash<uint64_t>()(p_key.source ^ ((uint64_t)p_key.signal_id * 0x9E3779B97F4A7C15ull));
+		}
+	};
+
+	struct Connection {
+		uint64_t source;
+		godot::StringName signal;
+		godot::Callable callable;
+	};
+
+	std::mutex _mutex;
+	std::condition_variable _space_var;
+	std::vector<Slot> _ring;
+	size_t _head = 0; // Next slot to read.
+	size_t _count = 0; // Slots between head and the write position, including coalesced (dead) ones.
+	uint32_t _live = 0;
+	std::unordered_map<Key, size_t, KeyHash> _pending_keys;
+	OverflowPolicy _policy;
+	std::chrono::milliseconds _block_timeout;
+	// Thread that drains the stream, a push on it must not block.
+	std::atomic<std::thread::id> _drain_thread;
+	Stats _stats;
+
+	std::vector<std::string> _signal_names;
+	std::vector<Connection> _connections;
+	bool _closed = false;
+
+	void release(Slot &p_slot);
+	void make_room();
+	void disconnect_all();
+
+public:
+	GodotEventStream(uint32_t p_capacity, OverflowPolicy p_policy, uint32_t p_block_timeout_ms);
+	~GodotEventStream();
+
+	static bool parse_policy(const std::string &p_name, OverflowPolicy &r_policy);
+
+	// Connects to a signal of a Godot object, called on the Godot thread.
+	// Returns the signal id, or -1 on failure.
+	int connect(godot::Object *p_object, const std::string &p_signal);
+
+	// Stops accepting events and posts the disconnects to the Godot thread.
+	// The caller has to hold a shared_ptr to the stream, it is kept alive
+	// until the disconnects ran.
+	void close();
+
+	// Closes all streams and releases their connections, called by
+	// destroy_instance() while the engine is still loaded.
+	static void close_all();
+
+	// Queues an event, called from the signal callable.
+	void push(uint32_t p_signal_id, uint64_t p_source, const godot::Variant **p_arguments, int p_argcount);
+
+	// Moves up to p_max pending events to r_events, oldest first. The
+	// calling thread is taken as the consumer thread from then on.
+	size_t drain(std::vector<Event> &r_events, size_t p_max);
+
+	// Counts drained events the consumer could not decode or convert.
+	void add_invalid(uint64_t p_count);
+
+	std::string get_signal_name(uint32_t p_signal_id);
+
+	Stats get_stats();
+};
@@ -25,16 +25,21 @@
 
 #pragma once
 
+#include "TaskExecutor.h"
+
 #include <godot_cpp/classes/godot_instance.hpp>
 #include <godot_cpp/classes/rendering_native_surface.hpp>
 
 #include <future>
 #include <mutex>
+#include <string>
+#include <vector>
 
 struct PlatformData {};
 
 class GodotModule {
 	godot::GodotInstance *_instance = nullptr;
+	std::vector<std::string> _instance_args;
 	PlatformData *_data = nullptr;
 
 	std::mutex _mutex;
@@ -54,6 +59,13 @@ public:
 		return _instance;
 	}
 
+	// Arguments the running instance was created with, without the ones
+	// added by the module itself. Empty if there is no instance.
+	std::vector<std::string> get_instance_args() {
+		std::unique_lock lock(_mutex);
+		return _instance_args;
+	}
+
 	void destroy_instance();
 
 	godot::Ref<godot::RenderingNativeSurface> get_main_rendering_surface();
@@ -87,7 +99,15 @@ public:
 
 	void updateWindows(bool adding);
 
-	void runOnGodotThread(std::function<void()> f, bool wait = false);
+	void runOnGodotThread(std::function<void()> f, bool wait = false, TaskPriority priority = TASK_PRIORITY_FRAME);
+
+	// Runs f on the Godot thread and waits for it without copying or allocating.
+	template <typename F>
+	void runOnGodotThreadSync(F &&f, TaskPriority priority = TASK_PRIORITY_URGENT) {
+		get_thread()->run_sync(f, priority);
+	}
+
+	TaskExecutor *get_thread();
 
 	void iterate();
 
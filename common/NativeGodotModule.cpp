@@ -27,15 +27,32 @@
 #include "NativeGodotModule.h"
 #include "godot-log.h"
 
+#include "ArrayKernels.h"
+#include "BridgeMetrics.h"
+#include "CallArena.h"
+#include "FileRoute.h"
+#include "GodotEventStream.h"
 #include "GodotModule.h"
+#include "ResourcePreloader.h"
+#include "SceneSnapshot.h"
+#include "ShaderCache.h"
+#include "StartupTrace.h"
+#include "StateChannel.h"
+#include "StringTransfer.h"
+#include "SyncCall.h"
+#include "VariantCodec.h"
 #include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/core/class_db.hpp>
 
-#include <condition_variable>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <type_traits>
 
 #ifdef ON_ANDROID
 #include <fbjni/fbjni.h>
@@ -75,54 +92,99 @@ static std::string create_method_call_error_string(std::string methodName, GDExt
 	return ret;
 }
 
-static std::vector<const godot::Variant *> createVariantArgArray(const std::vector<godot::Variant> &args) {
-	std::vector<const godot::Variant *> ret;
-	ret.reserve(args.size());
-	for (int i = 0; i < args.size(); ++i) {
-		ret.push_back(&args[i]);
+// Exposes the memory of a StateChannel as an ArrayBuffer without copying.
+class StateChannelBuffer : public jsi::MutableBuffer {
+	std::shared_ptr<StateChannel> _channel;
+
+public:
+	StateChannelBuffer(std::shared_ptr<StateChannel> channel) :
+			_channel(channel) {}
+
+	size_t size() const override {
+		return _channel->get_size();
 	}
-	return ret;
+
+	uint8_t *data() override {
+		return _channel->get_data();
+	}
+};
+
+// Hands an encoded buffer over to an ArrayBuffer without copying.
+class ByteVectorBuffer : public jsi::MutableBuffer {
+	std::vector<uint8_t> _data;
+
+public:
+	ByteVectorBuffer(std::vector<uint8_t> &&data) :
+			_data(std::move(data)) {}
+
+	size_t size() const override {
+		return _data.size();
+	}
+
+	uint8_t *data() override {
+		return _data.data();
+	}
+};
+
+// Waiter of the React JS thread, see JavascriptCallable::runInContext.
+// Converts a JS number to an integer from p_min to p_max. Fractional,
+// non-finite and out of range numbers throw rather than being cast.
+static size_t readIntegerArg(jsi::Runtime &rt, const jsi::Value &value, size_t p_min, size_t p_max, const char *caller, const char *name) {
+	size_t result = 0;
+	if (!value.isNumber() || !ArrayKernels::to_index(value.asNumber(), result) || result < p_min || result > p_max) {
+		throw jsi::JSError(rt, std::string(caller) + ": " + name + " has to be an integer from " + std::to_string(p_min) + " to " + std::to_string(p_max) + "!");
+	}
+	return result;
 }
 
+// Upper limits of JS configuration values.
+static const uint32_t MAX_BLOCK_TIMEOUT_MS = 10000;
+static const uint32_t MAX_PRELOAD_CONCURRENT = 64;
+static const uint32_t MAX_FRAME_RESERVE_MS = 100;
+
+static std::atomic<SyncWaiter *> jsThreadWaiter = nullptr;
+
 static const char *JAVASCRIPT_CALLABLE_NAME = "JavascriptCallable";
 class JavascriptCallable : public godot::CallableCustom {
 	std::weak_ptr<RNWorklet::JsiWorkletContext> _workletContext;
 	bool _isWorklet;
 	jsi::Value _funcValue;
 
-	static bool runInContext(const JavascriptCallable *c,
-			std::function<bool(const JavascriptCallable *, jsi::Runtime &)> func) {
+	template <typename F>
+	static bool runInContext(const JavascriptCallable *c, F &&func) {
 		std::shared_ptr<RNWorklet::JsiWorkletContext> wc = c->_workletContext.lock();
 		if (!wc) {
 			LOGE("WorkletContext is invalid");
 			return false;
 		}
-		{
-			std::mutex mtx;
-			std::condition_variable cv;
-			bool done = false;
-			bool err = false;
-			if (c->_isWorklet) {
-				wc->invokeOnWorkletThread([&err, &func, &c, &done, &mtx, &cv](RNWorklet::JsiWorkletContext *wc, jsi::Runtime &rt) {
-					err = func(c, rt);
-					std::unique_lock<std::mutex> lock(mtx);
-					done = true;
-					cv.notify_one();
-				});
-			} else {
-				wc->invokeOnJsThread([&err, &func, &c, &done, &mtx, &cv](jsi::Runtime &rt) {
-					err = func(c, rt);
-					std::unique_lock<std::mutex> lock(mtx);
-					done = true;
-					cv.notify_one();
-				});
-			}
-			{
-				std::unique_lock<std::mutex> lock(mtx);
-				cv.wait(lock, [&]() { return done; });
-			}
+		bool err = false;
+		if (c->_isWorklet) {
+			// The worklet thread is the Godot thread.
+			GodotModule::get_singleton()->runOnGodotThreadSync([&err, &func, &c, &wc]() {
+				err = func(c, wc->getWorkletRuntime());
+			});
 			return err;
 		}
+		jsi::Runtime *jsRuntime = wc->getJsRuntime();
+		SyncWaiter *jsWaiter = jsThreadWaiter.load(std::memory_order_acquire);
+		if (jsWaiter == SyncWaiter::get_current()) {
+			return func(c, *jsRuntime);
+		}
+		auto runFunc = [&err, &func, &c, jsRuntime]() {
+			err = func(c, *jsRuntime);
+		};
+		SyncCall call(runFunc);
+		// If the JS thread is itself blocked in a synchronous call (e.g. into
+		// Godot), hand the call to it directly, it would never reach the
+		// CallInvoker queue otherwise.
+		if (!jsWaiter || !jsWaiter->post(&call)) {
+			// Capture a single reference, so the callback fits into the inline storage of std::function.
+			wc->invokeOnJsThread([&call](jsi::Runtime &rt) {
+				call.run();
+			});
+		}
+		call.wait();
+		return err;
 	}
 
 public:
@@ -248,6 +310,7 @@ class GodotHostObject : public jsi::HostObject {
 
 public:
 	static godot::Variant jsiValueToGodotVariant(std::shared_ptr<RNWorklet::JsiWorkletContext> workletContext, jsi::Runtime &rt, const jsi::Value &value) {
+		BridgeMetrics::Scope metric(BRIDGE_TO_VARIANT);
 		if (value.isNull() || value.isUndefined()) {
 			return godot::Variant(nullptr);
 		}
@@ -258,8 +321,7 @@ public:
 			return godot::Variant(value.asNumber());
 		}
 		if (value.isString()) {
-			std::string s = value.asString(rt).utf8(rt);
-			return godot::Variant(godot::String::utf8(s.c_str()));
+			return godot::Variant(StringTransfer::to_godot(rt, value.asString(rt)));
 		}
 		if (value.isBigInt()) {
 			jsi::BigInt b = value.asBigInt(rt);
@@ -287,6 +349,7 @@ public:
 	}
 
 	static jsi::Value godotVariantToJsiValue(std::shared_ptr<RNWorklet::JsiWorkletContext> workletContext, jsi::Runtime &rt, const godot::Variant &variant) {
+		BridgeMetrics::Scope metric(BRIDGE_FROM_VARIANT);
 		switch (variant.get_type()) {
 			case godot::Variant::Type::NIL: {
 				return jsi::Value::null();
@@ -303,10 +366,8 @@ public:
 			}
 			case godot::Variant::Type::STRING: {
 				godot::String s = variant;
-				LOGI("Godot Variant String to JSI: %s", s.utf8().get_data());
-				jsi::String ret = jsi::String::createFromUtf8(rt, (uint8_t *)s.utf8().get_data(), s.length());
-				LOGI("JSI String: %s", ret.utf8(rt).c_str());
-				return ret;
+				LOG_THROTTLED(GODOT_LOG_LEVEL_VERBOSE, 1000, "Godot Variant String to JSI: %s", s.utf8().get_data());
+				return StringTransfer::to_jsi(rt, s);
 			}
 			// math types
 			case godot::Variant::Type::VECTOR2:
@@ -332,7 +393,7 @@ public:
 			}
 			case godot::Variant::Type::STRING_NAME: {
 				godot::StringName sn = variant;
-				return jsi::String::createFromUtf8(rt, sn.to_utf8_buffer().ptr(), sn.length());
+				return StringTransfer::to_jsi(rt, godot::String(sn));
 			}
 			case godot::Variant::Type::NODE_PATH:
 			case godot::Variant::Type::RID: {
@@ -376,11 +437,11 @@ public:
 			jsi::HostObject(), _workletContext(workletContext), _value(v) {}
 
 	~GodotHostObject() {
-		LOGI("Destructing Godot object of type: %d", _value.get_type());
+		LOG_THROTTLED(GODOT_LOG_LEVEL_VERBOSE, 1000, "Destructing Godot object of type: %d", _value.get_type());
 	}
 
 	jsi::Value get(jsi::Runtime &rt, const jsi::PropNameID &name) override {
-		godot::StringName propName(name.utf8(rt).c_str());
+		godot::StringName propName = StringTransfer::to_godot_name(rt, name);
 		if (_value.get_type() == godot::Variant::Type::NIL) {
 			return jsi::Value(nullptr);
 		}
@@ -388,6 +449,7 @@ public:
 			std::shared_ptr<RNWorklet::JsiWorkletContext> wc = _workletContext;
 			return jsi::Function::createFromHostFunction(rt, name, 0, [propName, wc](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
 				// LOGI("Calling: %s", propName.to_utf8_buffer().ptr());
+				BridgeMetrics::Scope metric(BRIDGE_METHOD_CALL);
 				if (!thisVal.isObject()) {
 					throw jsi::JSINativeException("Calling Godot Method on a value that is not an object");
 				}
@@ -398,13 +460,13 @@ public:
 				}
 
 				std::shared_ptr<GodotHostObject> ho = obj.getHostObject<GodotHostObject>(rt);
-				std::vector<godot::Variant> godotArgs;
-				godotArgs.reserve(count);
+				CallArena::Scope scope;
+				ArenaArray<godot::Variant> godotArgs(scope, count);
+				ArenaArray<const godot::Variant *> variantArgs(scope, count);
 				for (int i = 0; i < count; ++i) {
-					godotArgs.push_back(jsiValueToGodotVariant(wc, rt, args[i]));
+					variantArgs.emplace_back(&godotArgs.emplace_back(jsiValueToGodotVariant(wc, rt, args[i])));
 				}
 
-				std::vector<const godot::Variant *> variantArgs = createVariantArgArray(godotArgs);
 				godot::Variant r_ret;
 				GDExtensionCallError r_error;
 				ho->_value.callp(propName, variantArgs.data(), count, r_ret, r_error);
@@ -426,7 +488,7 @@ public:
 	}
 
 	void set(jsi::Runtime &rt, const jsi::PropNameID &name, const jsi::Value &value) override {
-		godot::StringName propName(name.utf8(rt).c_str());
+		godot::StringName propName = StringTransfer::to_godot_name(rt, name);
 		bool r_valid = false;
 		_value.set_named(propName, jsiValueToGodotVariant(_workletContext, rt, value), r_valid);
 		if (!r_valid) {
@@ -435,6 +497,135 @@ public:
 	}
 };
 
+class GodotEventStreamHostObject : public jsi::HostObject {
+	std::shared_ptr<RNWorklet::JsiWorkletContext> _workletContext;
+	std::shared_ptr<GodotEventStream> _stream;
+
+public:
+	GodotEventStreamHostObject(std::shared_ptr<RNWorklet::JsiWorkletContext> workletContext, std::shared_ptr<GodotEventStream> stream) :
+			_workletContext(workletContext), _stream(stream) {}
+
+	~GodotEventStreamHostObject() {
+		_stream->close();
+	}
+
+	jsi::Value get(jsi::Runtime &rt, const jsi::PropNameID &name) override {
+		std::string propName = name.utf8(rt);
+		std::shared_ptr<GodotEventStream> stream = _stream;
+		std::shared_ptr<RNWorklet::JsiWorkletContext> wc = _workletContext;
+		if (propName == "connect") {
+			// connect(object, signal: string): number
+			return jsi::Function::createFromHostFunction(rt, name, 2, [stream, wc](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+				if (count < 2 || !args[1].isString()) {
+					throw jsi::JSError(rt, "connect: Expected a Godot object and a signal name!");
+				}
+				godot::Variant target = GodotHostObject::jsiValueToGodotVariant(wc, rt, args[0]);
+				if (target.get_type() != godot::Variant::Type::OBJECT) {
+					throw jsi::JSError(rt, "connect: First argument has to be a Godot object!");
+				}
+				std::string signal = args[1].asString(rt).utf8(rt);
+				if (!GodotModule::get_singleton()->get_instance()) {
+					throw jsi::JSError(rt, "connect: Godot instance is not running!");
+				}
+				int id = -1;
+				auto connect = [&id, &stream, &target, &signal]() {
+					id = stream->connect((godot::Object *)target, signal);
+				};
+				GodotModule::get_singleton()->runOnGodotThreadSync(connect);
+				if (id < 0) {
+					throw jsi::JSError(rt, "connect: Unable to connect to signal: " + signal);
+				}
+				return jsi::Value(id);
+			});
+		}
+		if (propName == "drain") {
+			// drain(max?: number): Array<{ signal, signalId, source, args }>
+			return jsi::Function::createFromHostFunction(rt, name, 1, [stream, wc](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+				size_t max = SIZE_MAX;
+				if (count > 0 && args[0].isNumber()) {
+					max = readIntegerArg(rt, args[0], 0, SIZE_MAX, "drain", "max");
+				}
+				std::vector<GodotEventStream::Event> events;
+				stream->drain(events, max);
+				std::vector<jsi::Value> signalNames;
+				std::vector<jsi::Object> converted;
+				converted.reserve(events.size());
+				uint64_t invalid = 0;
+				for (const GodotEventStream::Event &event : events) {
+					// An event with arguments that cannot be decoded or converted
+					// is skipped and counted, the rest of the batch is kept.
+					jsi::Array eventArgs(rt, event.argcount);
+					const uint8_t *data = event.payload.data();
+					size_t remaining = event.payload.size();
+					bool valid = true;
+					for (uint32_t a = 0; a < event.argcount && valid; ++a) {
+						godot::Variant arg;
+						size_t used = 0;
+						if (!VariantCodec::decode(data, remaining, arg, used)) {
+							valid = false;
+							break;
+						}
+						data += used;
+						remaining -= used;
+						try {
+							eventArgs.setValueAtIndex(rt, a, GodotHostObject::godotVariantToJsiValue(wc, rt, arg));
+						} catch (const jsi::JSIException &e) {
+							LOGE("drain: Skipping event with an unsupported argument: %s", e.what());
+							valid = false;
+						}
+					}
+					if (!valid) {
+						invalid++;
+						continue;
+					}
+					while (signalNames.size() <= event.signal_id) {
+						signalNames.push_back(jsi::String::createFromUtf8(rt, stream->get_signal_name(signalNames.size())));
+					}
+					jsi::Object o(rt);
+					o.setProperty(rt, "signal", jsi::Value(rt, signalNames[event.signal_id]));
+					o.setProperty(rt, "signalId", jsi::Value((double)event.signal_id));
+					o.setProperty(rt, "source", jsi::BigInt::fromUint64(rt, event.source));
+					o.setProperty(rt, "args", eventArgs);
+					converted.push_back(std::move(o));
+				}
+				if (invalid > 0) {
+					stream->add_invalid(invalid);
+				}
+				jsi::Array result(rt, converted.size());
+				for (size_t i = 0; i < converted.size(); ++i) {
+					result.setValueAtIndex(rt, i, converted[i]);
+				}
+				return jsi::Value(rt, result);
+			});
+		}
+		if (propName == "getStats") {
+			return jsi::Function::createFromHostFunction(rt, name, 0, [stream](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+				GodotEventStream::Stats stats = stream->get_stats();
+				jsi::Object o(rt);
+				o.setProperty(rt, "pushed", jsi::Value((double)stats.pushed));
+				o.setProperty(rt, "dropped", jsi::Value((double)stats.dropped));
+				o.setProperty(rt, "coalesced", jsi::Value((double)stats.coalesced));
+				o.setProperty(rt, "blocked", jsi::Value((double)stats.blocked));
+				o.setProperty(rt, "invalid", jsi::Value((double)stats.invalid));
+				o.setProperty(rt, "pending", jsi::Value((double)stats.pending));
+				o.setProperty(rt, "capacity", jsi::Value((double)stats.capacity));
+				return jsi::Value(rt, o);
+			});
+		}
+		if (propName == "close") {
+			return jsi::Function::createFromHostFunction(rt, name, 0, [stream](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+				stream->close();
+				return jsi::Value::undefined();
+			});
+		}
+		return jsi::Value::undefined();
+	}
+
+	void set(jsi::Runtime &rt, const jsi::PropNameID &name, const jsi::Value &value) override {
+		throw jsi::JSINativeException("Setting property values is not supported on GodotEventStream");
+	}
+};
+
 class GodotAPIObject : public jsi::HostObject {
 	std::shared_ptr<RNWorklet::JsiWorkletContext> _workletContext;
 	std::map<std::string, jsi::Value> builtin_types;
@@ -452,12 +643,13 @@ public:
 
 	static jsi::Value createStaticFunction(std::shared_ptr<RNWorklet::JsiWorkletContext> workletContext, jsi::Runtime &rt, std::string name, GDExtensionMethodBindPtr mb) {
 		jsi::Function f = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, name), 0, [name, mb, workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
-			std::vector<godot::Variant> godotArgs;
-			godotArgs.reserve(count);
+			BridgeMetrics::Scope metric(BRIDGE_STATIC_CALL);
+			CallArena::Scope scope;
+			ArenaArray<godot::Variant> godotArgs(scope, count);
+			ArenaArray<const godot::Variant *> variantArgs(scope, count);
 			for (int i = 0; i < count; ++i) {
-				godotArgs.push_back(GodotHostObject::jsiValueToGodotVariant(workletContext, rt, args[i]));
+				variantArgs.emplace_back(&godotArgs.emplace_back(GodotHostObject::jsiValueToGodotVariant(workletContext, rt, args[i])));
 			}
-			std::vector<const godot::Variant *> variantArgs = createVariantArgArray(godotArgs);
 			godot::Variant r_ret;
 			GDExtensionCallError r_error;
 
@@ -539,6 +731,7 @@ public:
 	}
 
 	jsi::Value get(jsi::Runtime &rt, const jsi::PropNameID &name) override {
+		BridgeMetrics::Scope metric(BRIDGE_TYPE_LOOKUP);
 		if (GodotModule::get_singleton()->get_instance() == nullptr) {
 			throw jsi::JSINativeException("Godot Engine not initialized yet.");
 		}
@@ -568,6 +761,7 @@ public:
 };
 
 void JavascriptCallable::call(const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) const {
+	BridgeMetrics::Scope metric(BRIDGE_JS_CALLABLE);
 	std::shared_ptr<RNWorklet::JsiWorkletContext> wc = _workletContext.lock();
 	if (!wc) {
 		// Func ref no longer valid
@@ -597,10 +791,10 @@ void JavascriptCallable::call(const godot::Variant **p_arguments, int p_argcount
 		}
 		jsi::Function func = obj.asFunction(rt);
 
-		std::vector<jsi::Value> args;
-		args.reserve(p_argcount);
+		CallArena::Scope scope;
+		ArenaArray<jsi::Value> args(scope, p_argcount);
 		for (int i = 0; i < p_argcount; ++i) {
-			args.push_back(GodotHostObject::godotVariantToJsiValue(wc, rt, *p_arguments[i]));
+			args.emplace_back(GodotHostObject::godotVariantToJsiValue(wc, rt, *p_arguments[i]));
 		}
 		const jsi::Value *argptr = args.data();
 		jsi::Value ret = func.call(rt, argptr, (size_t)p_argcount);
@@ -611,10 +805,205 @@ void JavascriptCallable::call(const godot::Variant **p_arguments, int p_argcount
 	runInContext(this, caller);
 }
 
+static TaskPriority parseTaskPriority(jsi::Runtime &rt, const jsi::Value &value, const char *caller) {
+	if (value.isUndefined()) {
+		return TASK_PRIORITY_FRAME;
+	}
+	std::string p = value.toString(rt).utf8(rt);
+	if (p == "urgent") {
+		return TASK_PRIORITY_URGENT;
+	} else if (p == "frame") {
+		return TASK_PRIORITY_FRAME;
+	} else if (p == "background") {
+		return TASK_PRIORITY_BACKGROUND;
+	}
+	throw jsi::JSError(rt, std::string(caller) + ": Unknown priority: " + p);
+}
+
+// Settles a promise made by createPromise(), from any thread. The value is
+// created on the thread of the runtime the promise belongs to.
+using PromiseValue = std::function<jsi::Value(jsi::Runtime &, std::shared_ptr<RNWorklet::JsiWorkletContext>)>;
+using PromiseSettler = std::function<void(PromiseValue value, const std::string &error)>;
+
+static jsi::Value createPromise(jsi::Runtime &rt, std::shared_ptr<RNWorklet::JsiWorkletContext> workletContext, std::function<void(PromiseSettler)> start) {
+	bool isWorklet = workletContext->getJsRuntime() != &rt;
+	std::weak_ptr<RNWorklet::JsiWorkletContext> weakContext = workletContext;
+	auto executor = jsi::Function::createFromHostFunction(rt,
+			jsi::PropNameID::forAscii(rt, "promiseExecutor"),
+			2,
+			[start, isWorklet, weakContext](jsi::Runtime &rt, const jsi::Value &thisValue, const jsi::Value *arguments, size_t count) -> jsi::Value {
+				auto resolverValue = std::make_shared<jsi::Value>(arguments[0].asObject(rt));
+				auto rejecterValue = std::make_shared<jsi::Value>(arguments[1].asObject(rt));
+				start([resolverValue, rejecterValue, isWorklet, weakContext](PromiseValue value, const std::string &error) {
+					std::shared_ptr<RNWorklet::JsiWorkletContext> ctx = weakContext.lock();
+					if (!ctx) {
+						return;
+					}
+					auto settle = [resolverValue, rejecterValue, ctx, value, error](jsi::Runtime &rt) {
+						if (error.empty()) {
+							resolverValue->asObject(rt).asFunction(rt).call(rt, value(rt, ctx));
+						} else {
+							rejecterValue->asObject(rt).asFunction(rt).call(rt, jsi::String::createFromUtf8(rt, error));
+						}
+					};
+					if (isWorklet) {
+						// The worklet thread is the Godot thread.
+						GodotModule::get_singleton()->runOnGodotThread([ctx, settle]() {
+							settle(ctx->getWorkletRuntime());
+						});
+					} else {
+						ctx->invokeOnJsThread(settle);
+					}
+				});
+				return jsi::Value::undefined();
+			});
+	return rt.global()
+			.getPropertyAsFunction(rt, "Promise")
+			.callAsConstructor(rt, executor);
+}
+
+// Numbers of a Float64Array, Float32Array, ArrayBuffer (read as float64)
+// or plain Array, without copying typed arrays.
+struct NumberSource {
+	const double *f64 = nullptr;
+	const float *f32 = nullptr;
+	size_t length = 0;
+	std::vector<double> values;
+};
+
+static std::string getConstructorName(jsi::Runtime &rt, const jsi::Object &obj) {
+	jsi::Value ctor = obj.getProperty(rt, "constructor");
+	if (!ctor.isObject()) {
+		return "";
+	}
+	jsi::Value name = ctor.asObject(rt).getProperty(rt, "name");
+	return name.isString() ? name.asString(rt).utf8(rt) : "";
+}
+
+static NumberSource readNumberSource(jsi::Runtime &rt, const jsi::Value &value, const char *caller) {
+	NumberSource source;
+	if (!value.isObject()) {
+		throw jsi::JSError(rt, std::string(caller) + ": Expected a Float64Array, Float32Array, ArrayBuffer or Array!");
+	}
+	jsi::Object obj = value.asObject(rt);
+	if (obj.isArrayBuffer(rt)) {
+		jsi::ArrayBuffer buffer = obj.getArrayBuffer(rt);
+		source.f64 = (const double *)buffer.data(rt);
+		source.length = buffer.size(rt) / sizeof(double);
+		return source;
+	}
+	if (obj.isArray(rt)) {
+		jsi::Array arr = obj.asArray(rt);
+		source.length = arr.length(rt);
+		source.values.resize(source.length);
+		for (size_t i = 0; i < source.length; i++) {
+			source.values[i] = arr.getValueAtIndex(rt, i).asNumber();
+		}
+		source.f64 = source.values.data();
+		return source;
+	}
+	std::string type = getConstructorName(rt, obj);
+	if (type == "Float64Array" || type == "Float32Array") {
+		jsi::Value buffer = obj.getProperty(rt, "buffer");
+		if (buffer.isObject() && buffer.asObject(rt).isArrayBuffer(rt)) {
+			// The view is identified by its constructor name only, so its
+			// properties are checked against the buffer before use.
+			jsi::ArrayBuffer arrayBuffer = buffer.asObject(rt).getArrayBuffer(rt);
+			size_t elementSize = type == "Float64Array" ? sizeof(double) : sizeof(float);
+			jsi::Value byteOffsetValue = obj.getProperty(rt, "byteOffset");
+			jsi::Value lengthValue = obj.getProperty(rt, "length");
+			size_t byteOffset = 0;
+			if (!byteOffsetValue.isNumber() || !lengthValue.isNumber() ||
+					!ArrayKernels::to_index(byteOffsetValue.asNumber(), byteOffset) ||
+					!ArrayKernels::to_index(lengthValue.asNumber(), source.length) ||
+					!ArrayKernels::is_view_in_bounds(byteOffset, source.length, elementSize, arrayBuffer.size(rt))) {
+				throw jsi::JSError(rt, std::string(caller) + ": " + type + " is outside of its buffer!");
+			}
+			uint8_t *data = arrayBuffer.data(rt) + byteOffset;
+			if (type == "Float64Array") {
+				source.f64 = (const double *)data;
+			} else {
+				source.f32 = (const float *)data;
+			}
+			return source;
+		}
+	}
+	throw jsi::JSError(rt, std::string(caller) + ": Expected a Float64Array, Float32Array, ArrayBuffer or Array!");
+}
+
+// Layout options shared by the packed array conversions, all in values:
+// offset of the first element, stride between elements, number of elements.
+struct ArrayLayout {
+	size_t offset = 0;
+	size_t stride = 0;
+	size_t count = 0;
+};
+
+// Reads an optional index option, undefined keeps r_value.
+static bool readIndexOption(jsi::Runtime &rt, const jsi::Object &options, const char *name, size_t &r_value, const char *caller) {
+	jsi::Value value = options.getProperty(rt, name);
+	if (value.isUndefined() || value.isNull()) {
+		return false;
+	}
+	if (!value.isNumber() || !ArrayKernels::to_index(value.asNumber(), r_value)) {
+		throw jsi::JSError(rt, std::string(caller) + ": " + name + " has to be a non-negative integer!");
+	}
+	return true;
+}
+
+static ArrayLayout readArrayLayout(jsi::Runtime &rt, const jsi::Value *args, size_t count, size_t index, size_t length, size_t components, const char *caller) {
+	ArrayLayout layout;
+	layout.stride = components;
+	bool hasCount = false;
+	if (count > index && args[index].isObject()) {
+		jsi::Object options = args[index].asObject(rt);
+		readIndexOption(rt, options, "offset", layout.offset, caller);
+		readIndexOption(rt, options, "stride", layout.stride, caller);
+		hasCount = readIndexOption(rt, options, "count", layout.count, caller);
+	}
+	if (layout.stride < components) {
+		throw jsi::JSError(rt, std::string(caller) + ": Stride is smaller than the element size!");
+	}
+	size_t available = 0;
+	if (layout.offset <= length && length - layout.offset >= components) {
+		available = (length - layout.offset - components) / layout.stride + 1;
+	}
+	if (!hasCount) {
+		layout.count = available;
+	} else if (layout.count > available) {
+		throw jsi::JSError(rt, std::string(caller) + ": Array is too short for the requested count!");
+	}
+	return layout;
+}
+
+// Copies layout.count elements of the source into r_dst, packed.
+template <typename T>
+static void copyNumbers(const NumberSource &source, const ArrayLayout &layout, size_t components, T *r_dst) {
+	if constexpr (std::is_same_v<T, float>) {
+		if (source.f64) {
+			ArrayKernels::f64_to_f32_strided(source.f64 + layout.offset, layout.stride, r_dst, components, layout.count, components);
+			return;
+		}
+		for (size_t e = 0; e < layout.count; e++) {
+			std::copy_n(source.f32 + layout.offset + e * layout.stride, components, r_dst + e * components);
+		}
+	} else {
+		if (source.f32) {
+			ArrayKernels::f32_to_f64_strided(source.f32 + layout.offset, layout.stride, r_dst, components, layout.count, components);
+			return;
+		}
+		for (size_t e = 0; e < layout.count; e++) {
+			std::copy_n(source.f64 + layout.offset + e * layout.stride, components, r_dst + e * components);
+		}
+	}
+}
+
 jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<facebook::react::CallInvoker> &callInvoker) {
 	// Perform initialization
 
 	std::shared_ptr<facebook::react::CallInvoker> jsCallInvoker = callInvoker;
+	// Called on the JS thread.
+	jsThreadWaiter.store(SyncWaiter::get_current(), std::memory_order_release);
 
 	auto runOnJS = [jsCallInvoker](std::function<void()> &&f) {
 		// Run on React JS Runtime
@@ -631,28 +1020,38 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 			runOnJS,
 			runOnWorklet);
 
-	LOGI("NativeGodotModule::createNativeModule");
+	LOGI("NativeGodotModule::createNativeModule (array kernels: %s)", ArrayKernels::get_backend());
 
 	auto runOnGodotThreadFunc = [workletContext](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *arguments, size_t count) -> jsi::Value {
 		if (!arguments[0].isObject()) {
 			throw jsi::JSError(runtime, "runOnGodotThread: First argument has to be a function!");
 		}
 
+		TaskPriority priority = TASK_PRIORITY_FRAME;
+		if (count > 1) {
+			priority = parseTaskPriority(runtime, arguments[1], "runOnGodotThread");
+		}
+
 		auto worklet = std::make_shared<RNWorklet::JsiWorklet>(runtime, arguments[0]);
 		auto workletInvoker = std::make_shared<RNWorklet::WorkletInvoker>(worklet);
+		std::weak_ptr<RNWorklet::JsiWorkletContext> weakContext = workletContext;
 
 		auto runOnGodotCallback = jsi::Function::createFromHostFunction(runtime,
 				jsi::PropNameID::forAscii(runtime, "runOnGodotCallback"),
 				2,
-				[workletInvoker, workletContext](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *arguments, size_t count) -> jsi::Value {
+				[workletInvoker, workletContext, weakContext, priority](jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *arguments, size_t count) -> jsi::Value {
 					auto resolverValue = std::make_shared<jsi::Value>((arguments[0].asObject(runtime)));
 					auto rejecterValue = std::make_shared<jsi::Value>((arguments[1].asObject(runtime)));
 
-					auto resolver = [resolverValue, workletContext](std::shared_ptr<RNWorklet::JsiWrapper> wrappedValue) {
-						workletContext->invokeOnJsThread([resolverValue, wrappedValue](jsi::Runtime &runtime) {
+					uint64_t start = BridgeMetrics::is_enabled() ? BridgeMetrics::now_ns() : 0;
+					auto resolver = [resolverValue, workletContext, start](std::shared_ptr<RNWorklet::JsiWrapper> wrappedValue) {
+						workletContext->invokeOnJsThread([resolverValue, wrappedValue, start](jsi::Runtime &runtime) {
 							auto resolverFunc = resolverValue->asObject(runtime).asFunction(runtime);
 							auto resultValue = wrappedValue->unwrap(runtime);
 							resolverFunc.call(runtime, resultValue);
+							if (start) {
+								BridgeMetrics::record(BRIDGE_RUN_ON_GODOT_THREAD, BridgeMetrics::now_ns() - start);
+							}
 						});
 					};
 					auto rejecter = [rejecterValue, workletContext](const std::string &message) {
@@ -663,7 +1062,14 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 						});
 					};
 
-					workletContext->invokeOnWorkletThread([resolver, rejecter, workletInvoker](RNWorklet::JsiWorkletContext *ctx, jsi::Runtime &workletRT) {
+					// The worklet thread is the Godot thread, so the worklet can be queued
+					// directly in the requested lane.
+					std::function<void()> task = [resolver, rejecter, workletInvoker, weakContext]() {
+						std::shared_ptr<RNWorklet::JsiWorkletContext> ctx = weakContext.lock();
+						if (!ctx) {
+							return;
+						}
+						jsi::Runtime &workletRT = ctx->getWorkletRuntime();
 						try {
 							auto resultValue = workletInvoker->call(workletRT, jsi::Value::undefined(), nullptr, 0);
 							auto result = RNWorklet::JsiWrapper::wrap(workletRT, resultValue);
@@ -671,7 +1077,8 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 						} catch (std::exception &exc) {
 							rejecter(exc.what());
 						}
-					});
+					};
+					GodotModule::get_singleton()->runOnGodotThread(std::move(task), false, priority);
 					return jsi::Value::undefined();
 				});
 
@@ -727,16 +1134,30 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 			}
 		} else {
 			for (size_t i = 0; i < count; ++i) {
-				const jsi::Value &arg = args[0];
+				const jsi::Value &arg = args[i];
 				godotArgs.push_back(arg.toString(rt).utf8(rt));
 			}
 		}
 
 		GodotModule *mod = GodotModule::get_singleton();
+		bool created = mod->get_instance() == nullptr;
 		godot::GodotInstance *instance = mod->get_or_create_instance(godotArgs);
 		if (!instance) {
 			return jsi::Value::undefined();
 		}
+		// libgodot keeps the engine state in globals, so there can only be one
+		// instance per process. Asking for a differently configured one must
+		// not silently return the running instance, also when the host app
+		// created it natively.
+		if (mod->get_instance_args() != godotArgs) {
+			throw jsi::JSError(rt, "createInstance: A Godot instance with different arguments is already running, only one instance per process is supported. Call destroyInstance() first.");
+		}
+		if (created) {
+			mod->runOnGodotThread([]() {
+				ShaderCache::record_baseline();
+			},
+					false, TASK_PRIORITY_BACKGROUND);
+		}
 		return GodotHostObject::godotVariantToJsiValue(workletContext, rt, godot::Variant(instance));
 	};
 
@@ -758,6 +1179,7 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 
 	auto updateWindowFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
 		if (count >= 2) {
+			BridgeMetrics::Scope metric(BRIDGE_WINDOW_UPDATE);
 			GodotModule *mod = GodotModule::get_singleton();
 			mod->updateWindow(args[0].asString(rt).utf8(rt), args[1].asBool());
 		}
@@ -769,11 +1191,646 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 	};
 
 	auto destroyInstanceFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		ResourcePreloader::get_singleton()->fail_all("The Godot instance was destroyed");
 		GodotModule *mod = GodotModule::get_singleton();
 		mod->destroy_instance();
 		return jsi::Value::undefined();
 	};
 
+	auto setThreadConfigFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isObject()) {
+			throw jsi::JSError(rt, "setThreadConfig: First argument has to be an object!");
+		}
+		jsi::Object options = args[0].asObject(rt);
+		ThreadConfig config;
+		jsi::Value priority = options.getProperty(rt, "priority");
+		if (priority.isString()) {
+			std::string p = priority.asString(rt).utf8(rt);
+			if (p == "default") {
+				config.priority = ThreadConfig::PRIORITY_DEFAULT;
+			} else if (p == "high") {
+				config.priority = ThreadConfig::PRIORITY_HIGH;
+			} else if (p == "realtime") {
+				config.priority = ThreadConfig::PRIORITY_REALTIME;
+			} else {
+				throw jsi::JSError(rt, "setThreadConfig: Unknown priority: " + p);
+			}
+		}
+		jsi::Value bigCores = options.getProperty(rt, "bigCores");
+		if (bigCores.isBool()) {
+			config.prefer_big_cores = bigCores.getBool();
+		}
+		jsi::Value frameReserveMs = options.getProperty(rt, "frameReserveMs");
+		if (frameReserveMs.isNumber()) {
+			double reserve = frameReserveMs.asNumber();
+			if (!std::isfinite(reserve) || reserve < 0.0 || reserve > MAX_FRAME_RESERVE_MS) {
+				throw jsi::JSError(rt, "setThreadConfig: frameReserveMs has to be from 0 to " + std::to_string(MAX_FRAME_RESERVE_MS) + "!");
+			}
+			config.frame_reserve_us = (uint32_t)(reserve * 1000.0);
+		}
+		GodotModule::get_singleton()->get_thread()->configure(config);
+		return jsi::Value::undefined();
+	};
+
+	auto getThreadStatsFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		auto statsToObject = [&rt](const TaskStats &stats) {
+			jsi::Object o(rt);
+			o.setProperty(rt, "count", jsi::Value((double)stats.count));
+			o.setProperty(rt, "totalLatencyNs", jsi::Value((double)stats.total_latency_ns));
+			o.setProperty(rt, "maxLatencyNs", jsi::Value((double)stats.max_latency_ns));
+			o.setProperty(rt, "lastLatencyNs", jsi::Value((double)stats.last_latency_ns));
+			o.setProperty(rt, "deferred", jsi::Value((double)stats.deferred));
+			return o;
+		};
+		TaskExecutor *thread = GodotModule::get_singleton()->get_thread();
+		jsi::Object o = statsToObject(thread->get_stats());
+		jsi::Object lanes(rt);
+		lanes.setProperty(rt, "urgent", statsToObject(thread->get_stats(TASK_PRIORITY_URGENT)));
+		lanes.setProperty(rt, "frame", statsToObject(thread->get_stats(TASK_PRIORITY_FRAME)));
+		lanes.setProperty(rt, "background", statsToObject(thread->get_stats(TASK_PRIORITY_BACKGROUND)));
+		o.setProperty(rt, "lanes", lanes);
+		o.setProperty(rt, "sync", statsToObject(thread->get_sync_stats()));
+		CallArena::Stats arenaStats = CallArena::get_stats();
+		jsi::Object arena(rt);
+		arena.setProperty(rt, "heapAllocations", jsi::Value((double)arenaStats.heap_allocations));
+		arena.setProperty(rt, "highWaterBytes", jsi::Value((double)arenaStats.high_water));
+		o.setProperty(rt, "arena", arena);
+		ResourcePreloader::Stats preloadStats = ResourcePreloader::get_singleton()->get_stats();
+		jsi::Object preload(rt);
+		preload.setProperty(rt, "requested", jsi::Value((double)preloadStats.requested));
+		preload.setProperty(rt, "loaded", jsi::Value((double)preloadStats.loaded));
+		preload.setProperty(rt, "failed", jsi::Value((double)preloadStats.failed));
+		preload.setProperty(rt, "active", jsi::Value((double)preloadStats.active));
+		preload.setProperty(rt, "queued", jsi::Value((double)preloadStats.queued));
+		preload.setProperty(rt, "maxConcurrent", jsi::Value((double)preloadStats.max_concurrent));
+		preload.setProperty(rt, "totalLoadNs", jsi::Value((double)preloadStats.total_load_ns));
+		preload.setProperty(rt, "maxLoadNs", jsi::Value((double)preloadStats.max_load_ns));
+		preload.setProperty(rt, "lastLoadNs", jsi::Value((double)preloadStats.last_load_ns));
+		preload.setProperty(rt, "totalWaitNs", jsi::Value((double)preloadStats.total_wait_ns));
+		o.setProperty(rt, "preload", preload);
+		return jsi::Value(rt, o);
+	};
+	// preloadResource(path, { typeHint, priority, useSubThreads }): { path, promise, progress(), status() }
+	auto preloadResourceFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) -> jsi::Value {
+		if (count < 1 || !args[0].isString()) {
+			throw jsi::JSError(rt, "preloadResource: First argument has to be a string!");
+		}
+		if (!GodotModule::get_singleton()->get_instance()) {
+			throw jsi::JSError(rt, "preloadResource: No Godot instance is running!");
+		}
+		auto request = std::make_shared<ResourcePreloader::Request>();
+		request->path = args[0].asString(rt).utf8(rt);
+		if (count > 1 && args[1].isObject()) {
+			jsi::Object options = args[1].asObject(rt);
+			jsi::Value typeHint = options.getProperty(rt, "typeHint");
+			if (typeHint.isString()) {
+				request->type_hint = typeHint.asString(rt).utf8(rt);
+			}
+			jsi::Value useSubThreads = options.getProperty(rt, "useSubThreads");
+			if (useSubThreads.isBool()) {
+				request->use_sub_threads = useSubThreads.getBool();
+			}
+			jsi::Value priority = options.getProperty(rt, "priority");
+			if (priority.isString()) {
+				std::string p = priority.asString(rt).utf8(rt);
+				if (p == "high") {
+					request->priority = ResourcePreloader::PRIORITY_HIGH;
+				} else if (p == "normal") {
+					request->priority = ResourcePreloader::PRIORITY_NORMAL;
+				} else if (p == "low") {
+					request->priority = ResourcePreloader::PRIORITY_LOW;
+				} else {
+					throw jsi::JSError(rt, "preloadResource: Unknown priority: " + p);
+				}
+			}
+		}
+
+		jsi::Value promise = createPromise(rt, workletContext, [request](PromiseSettler settle) {
+			request->on_done = [settle](godot::Ref<godot::Resource> resource, const std::string &error) {
+				settle([resource](jsi::Runtime &rt, std::shared_ptr<RNWorklet::JsiWorkletContext> ctx) {
+					return GodotHostObject::godotVariantToJsiValue(ctx, rt, godot::Variant(resource));
+				},
+						error);
+			};
+		});
+		ResourcePreloader::get_singleton()->request(request);
+
+		jsi::Object handle(rt);
+		handle.setProperty(rt, "path", jsi::String::createFromUtf8(rt, request->path));
+		handle.setProperty(rt, "promise", promise);
+		handle.setProperty(rt, "progress", jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forAscii(rt, "progress"), 0, [request](jsi::Runtime &rt, const jsi::Value &thisValue, const jsi::Value *arguments, size_t count) {
+			return jsi::Value((double)request->progress.load(std::memory_order_relaxed));
+		}));
+		handle.setProperty(rt, "status", jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forAscii(rt, "status"), 0, [request](jsi::Runtime &rt, const jsi::Value &thisValue, const jsi::Value *arguments, size_t count) {
+			static const char *names[] = { "queued", "loading", "loaded", "failed" };
+			return jsi::Value(rt, jsi::String::createFromAscii(rt, names[request->status.load(std::memory_order_relaxed)]));
+		}));
+		return jsi::Value(rt, handle);
+	};
+
+	// warmUpShaders(paths): Promise<{ drawn, failed, ms }>
+	auto warmUpShadersFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) -> jsi::Value {
+		if (count < 1 || !args[0].isObject() || !args[0].asObject(rt).isArray(rt)) {
+			throw jsi::JSError(rt, "warmUpShaders: First argument has to be an array of paths!");
+		}
+		if (!GodotModule::get_singleton()->get_instance()) {
+			throw jsi::JSError(rt, "warmUpShaders: No Godot instance is running!");
+		}
+		jsi::Array paths = args[0].asObject(rt).asArray(rt);
+		std::vector<std::string> pathList;
+		for (size_t i = 0; i < paths.size(rt); i++) {
+			pathList.push_back(paths.getValueAtIndex(rt, i).toString(rt).utf8(rt));
+		}
+
+		return createPromise(rt, workletContext, [pathList](PromiseSettler settle) {
+			struct WarmUp {
+				std::mutex mutex;
+				std::vector<godot::Ref<godot::Resource>> resources;
+				size_t remaining;
+				uint32_t failed = 0;
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			};
+			auto warmUp = std::make_shared<WarmUp>();
+			warmUp->remaining = pathList.size();
+			auto draw = [warmUp, settle]() {
+				ShaderCache::warm_up(warmUp->resources, [warmUp, settle](uint32_t drawn) {
+					double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - warmUp->start).count();
+					uint32_t failed = warmUp->failed + (uint32_t)warmUp->resources.size() - drawn;
+					warmUp->resources.clear();
+					settle([drawn, failed, ms](jsi::Runtime &rt, std::shared_ptr<RNWorklet::JsiWorkletContext> ctx) {
+						jsi::Object o(rt);
+						o.setProperty(rt, "drawn", jsi::Value((double)drawn));
+						o.setProperty(rt, "failed", jsi::Value((double)failed));
+						o.setProperty(rt, "ms", jsi::Value(ms));
+						return jsi::Value(rt, o);
+					},
+							std::string());
+				});
+			};
+			if (pathList.empty()) {
+				GodotModule::get_singleton()->runOnGodotThread(draw);
+				return;
+			}
+			// Load in the background first, the Godot thread only draws.
+			for (const std::string &path : pathList) {
+				auto request = std::make_shared<ResourcePreloader::Request>();
+				request->path = path;
+				request->priority = ResourcePreloader::PRIORITY_LOW;
+				request->on_done = [warmUp, draw](godot::Ref<godot::Resource> resource, const std::string &error) {
+					std::lock_guard lock(warmUp->mutex);
+					if (resource.is_valid()) {
+						warmUp->resources.push_back(resource);
+					} else {
+						warmUp->failed++;
+					}
+					if (--warmUp->remaining == 0) {
+						GodotModule::get_singleton()->runOnGodotThread(draw, false, TASK_PRIORITY_BACKGROUND);
+					}
+				};
+				ResourcePreloader::get_singleton()->request(request);
+			}
+		});
+	};
+
+	// getShaderCacheStats(): Promise<GodotShaderCacheStats | null>
+	// The cache directories are scanned on the Godot thread as a background
+	// task, the JS thread does not wait for it.
+	auto getShaderCacheStatsFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		return createPromise(rt, workletContext, [](PromiseSettler settle) {
+			auto resolveNull = [](jsi::Runtime &rt, std::shared_ptr<RNWorklet::JsiWorkletContext> ctx) {
+				return jsi::Value::null();
+			};
+			if (!GodotModule::get_singleton()->get_instance()) {
+				settle(resolveNull, std::string());
+				return;
+			}
+			GodotModule::get_singleton()->runOnGodotThread([settle, resolveNull]() {
+				if (!GodotModule::get_singleton()->get_instance()) {
+					settle(resolveNull, std::string());
+					return;
+				}
+				ShaderCache::Stats stats = ShaderCache::get_stats();
+				settle([stats](jsi::Runtime &rt, std::shared_ptr<RNWorklet::JsiWorkletContext> ctx) {
+					jsi::Object o(rt);
+					o.setProperty(rt, "enabled", jsi::Value(stats.enabled));
+					o.setProperty(rt, "bytes", jsi::Value((double)stats.bytes));
+					o.setProperty(rt, "files", jsi::Value((double)stats.files));
+					o.setProperty(rt, "filesAtStart", jsi::Value((double)stats.files_at_start));
+					o.setProperty(rt, "warmUps", jsi::Value((double)stats.warm_ups));
+					o.setProperty(rt, "warmed", jsi::Value((double)stats.warmed));
+					o.setProperty(rt, "warmUpNs", jsi::Value((double)stats.warm_up_ns));
+					return jsi::Value(rt, o);
+				},
+						std::string());
+			},
+					false, TASK_PRIORITY_BACKGROUND);
+		});
+	};
+
+	auto setPreloadConfigFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isObject()) {
+			throw jsi::JSError(rt, "setPreloadConfig: First argument has to be an object!");
+		}
+		jsi::Value maxConcurrent = args[0].asObject(rt).getProperty(rt, "maxConcurrent");
+		if (maxConcurrent.isNumber()) {
+			ResourcePreloader::get_singleton()->set_max_concurrent(readIntegerArg(rt, maxConcurrent, 1, MAX_PRELOAD_CONCURRENT, "setPreloadConfig", "maxConcurrent"));
+		}
+		return jsi::Value::undefined();
+	};
+
+	auto getStartupReportFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		StartupTrace::Report report = StartupTrace::get_report();
+		jsi::Object o(rt);
+		o.setProperty(rt, "beginNs", jsi::Value((double)report.begin_ns));
+		jsi::Object phases(rt);
+		for (int i = 0; i < STARTUP_PHASE_MAX; i++) {
+			if (report.phase_ns[i]) {
+				phases.setProperty(rt, StartupTrace::get_name((StartupPhase)i), jsi::Value((double)report.phase_ns[i]));
+			}
+		}
+		o.setProperty(rt, "phasesNs", phases);
+		o.setProperty(rt, "complete", jsi::Value(report.phase_ns[STARTUP_FIRST_ITERATION] != 0));
+		o.setProperty(rt, "fromSnapshot", jsi::Value(report.from_snapshot));
+		return jsi::Value(rt, o);
+	};
+
+	auto writeStartupReportFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isString()) {
+			throw jsi::JSError(rt, "writeStartupReport: First argument has to be a path!");
+		}
+		return jsi::Value(StartupTrace::write(args[0].asString(rt).utf8(rt)));
+	};
+
+	// setSnapshotConfig({ path }): path of the .scn file, null disables snapshots.
+	auto setSnapshotConfigFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isObject()) {
+			throw jsi::JSError(rt, "setSnapshotConfig: First argument has to be an object!");
+		}
+		jsi::Value path = args[0].asObject(rt).getProperty(rt, "path");
+		if (path.isNull() || path.isUndefined()) {
+			SceneSnapshot::set_path(std::string());
+			return jsi::Value::undefined();
+		}
+		std::string p = path.toString(rt).utf8(rt);
+		if (p.empty() || p[0] != '/' || p.size() < 4 || p.compare(p.size() - 4, 4, ".scn") != 0) {
+			throw jsi::JSError(rt, "setSnapshotConfig: path has to be an absolute path ending in .scn!");
+		}
+		SceneSnapshot::set_path(p);
+		return jsi::Value::undefined();
+	};
+
+	auto discardSnapshotFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		SceneSnapshot::discard();
+		return jsi::Value::undefined();
+	};
+
+	auto getFileRouteFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isString()) {
+			throw jsi::JSError(rt, "getFileRoute: First argument has to be a path!");
+		}
+		std::string path = args[0].asString(rt).utf8(rt);
+		bool directory = count >= 2 && args[1].isBool() && args[1].getBool();
+		FileRoute::Route route = directory ? FileRoute::get_dir_route(path) : FileRoute::get_file_route(path);
+		return jsi::Value(jsi::String::createFromAscii(rt, FileRoute::get_name(route)));
+	};
+
+	auto setBridgeMetricsEnabledFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isBool()) {
+			throw jsi::JSError(rt, "setBridgeMetricsEnabled: First argument has to be a boolean!");
+		}
+		BridgeMetrics::set_enabled(args[0].getBool());
+		return jsi::Value::undefined();
+	};
+
+	auto getBridgeStatsFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		jsi::Object o(rt);
+		o.setProperty(rt, "enabled", jsi::Value(BridgeMetrics::is_enabled()));
+		jsi::Object metrics(rt);
+		for (int i = 0; i < BRIDGE_METRIC_MAX; i++) {
+			BridgeMetricStats stats = BridgeMetrics::get_stats((BridgeMetric)i);
+			jsi::Object m(rt);
+			m.setProperty(rt, "count", jsi::Value((double)stats.count));
+			m.setProperty(rt, "nsPerOp", jsi::Value(stats.count ? (double)stats.total_ns / stats.count : 0.0));
+			m.setProperty(rt, "p50Ns", jsi::Value((double)stats.p50_ns));
+			m.setProperty(rt, "p99Ns", jsi::Value((double)stats.p99_ns));
+			m.setProperty(rt, "maxNs", jsi::Value((double)stats.max_ns));
+			metrics.setProperty(rt, BridgeMetrics::get_name((BridgeMetric)i), m);
+		}
+		o.setProperty(rt, "metrics", metrics);
+		o.setProperty(rt, "arenaHeapAllocations", jsi::Value((double)CallArena::get_stats().heap_allocations));
+		return jsi::Value(rt, o);
+	};
+
+	auto resetBridgeStatsFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		BridgeMetrics::reset();
+		return jsi::Value::undefined();
+	};
+
+	auto setLogLevelFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isString()) {
+			throw jsi::JSError(rt, "setLogLevel: First argument has to be a string!");
+		}
+		std::string l = args[0].asString(rt).utf8(rt);
+		int level;
+		if (l == "verbose") {
+			level = GODOT_LOG_LEVEL_VERBOSE;
+		} else if (l == "debug") {
+			level = GODOT_LOG_LEVEL_DEBUG;
+		} else if (l == "info") {
+			level = GODOT_LOG_LEVEL_INFO;
+		} else if (l == "warn") {
+			level = GODOT_LOG_LEVEL_WARN;
+		} else if (l == "error") {
+			level = GODOT_LOG_LEVEL_ERROR;
+		} else if (l == "silent") {
+			level = GODOT_LOG_LEVEL_SILENT;
+		} else {
+			throw jsi::JSError(rt, "setLogLevel: Unknown log level: " + l);
+		}
+		godot_log_level.store(level, std::memory_order_relaxed);
+		return jsi::Value::undefined();
+	};
+
+	auto getLogLevelFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		// Levels below the compile time minimum are never logged.
+		int level = std::max(godot_log_level.load(std::memory_order_relaxed), GODOT_LOG_MIN_LEVEL);
+		const char *name = "silent";
+		switch (level) {
+			case GODOT_LOG_LEVEL_VERBOSE:
+				name = "verbose";
+				break;
+			case GODOT_LOG_LEVEL_DEBUG:
+				name = "debug";
+				break;
+			case GODOT_LOG_LEVEL_INFO:
+				name = "info";
+				break;
+			case GODOT_LOG_LEVEL_WARN:
+				name = "warn";
+				break;
+			case GODOT_LOG_LEVEL_ERROR:
+				name = "error";
+				break;
+		}
+		return jsi::Value(rt, jsi::String::createFromAscii(rt, name));
+	};
+
+	auto createStateChannelFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 2 || !args[0].isString() || !args[1].isObject()) {
+			throw jsi::JSError(rt, "createStateChannel: Expected a name and a layout object!");
+		}
+		if (!GodotModule::get_singleton()->get_instance()) {
+			throw jsi::JSError(rt, "createStateChannel: Godot instance is not running!");
+		}
+		std::string name = args[0].asString(rt).utf8(rt);
+		jsi::Object layoutObj = args[1].asObject(rt);
+		jsi::Array names = layoutObj.getPropertyNames(rt);
+		std::vector<std::pair<std::string, StateChannel::FieldType>> layout;
+		for (size_t i = 0; i < names.size(rt); ++i) {
+			std::string fieldName = names.getValueAtIndex(rt, i).asString(rt).utf8(rt);
+			std::string typeName = layoutObj.getProperty(rt, fieldName.c_str()).toString(rt).utf8(rt);
+			StateChannel::FieldType type;
+			if (!StateChannel::parse_field_type(typeName, type)) {
+				throw jsi::JSError(rt, "createStateChannel: Unknown field type: " + typeName);
+			}
+			layout.push_back(std::make_pair(fieldName, type));
+		}
+		std::shared_ptr<StateChannel> channel = StateChannel::get_or_create(name, layout);
+		if (!channel) {
+			throw jsi::JSError(rt, "createStateChannel: Channel exists with a different layout: " + name);
+		}
+
+		godot::Callable writer = GodotModule::get_singleton()->create_callable([channel](const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) {
+			r_return_value = channel->write(p_arguments, p_argcount);
+		});
+
+		jsi::Array fields(rt, channel->get_fields().size());
+		for (size_t i = 0; i < channel->get_fields().size(); ++i) {
+			const StateChannel::Field &field = channel->get_fields()[i];
+			jsi::Object f(rt);
+			f.setProperty(rt, "name", jsi::String::createFromUtf8(rt, field.name));
+			f.setProperty(rt, "type", jsi::String::createFromAscii(rt, StateChannel::get_field_type_name(field.type)));
+			f.setProperty(rt, "offset", jsi::Value((double)field.offset));
+			fields.setValueAtIndex(rt, i, f);
+		}
+
+		// Reads go through read(), which copies a consistent snapshot with
+		// the memory ordering plain JS loads of the shared buffer lack.
+		auto snapshot = std::make_shared<ByteVectorBuffer>(std::vector<uint8_t>(channel->get_size()));
+		jsi::Function read = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forAscii(rt, "read"),
+				0,
+				[channel, snapshot](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+					return jsi::Value(channel->read(snapshot->data()));
+				});
+
+		jsi::Object o(rt);
+		o.setProperty(rt, "name", jsi::String::createFromUtf8(rt, name));
+		o.setProperty(rt, "buffer", jsi::ArrayBuffer(rt, std::make_shared<StateChannelBuffer>(channel)));
+		o.setProperty(rt, "snapshot", jsi::ArrayBuffer(rt, snapshot));
+		o.setProperty(rt, "read", read);
+		o.setProperty(rt, "fields", fields);
+		o.setProperty(rt, "writer", GodotHostObject::godotVariantToJsiValue(workletContext, rt, godot::Variant(writer)));
+		return jsi::Value(rt, o);
+	};
+
+	auto releaseStateChannelFunc = [](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isString()) {
+			throw jsi::JSError(rt, "releaseStateChannel: First argument has to be a string!");
+		}
+		StateChannel::release(args[0].asString(rt).utf8(rt));
+		return jsi::Value::undefined();
+	};
+	auto createEventStreamFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (!GodotModule::get_singleton()->get_instance()) {
+			throw jsi::JSError(rt, "createEventStream: Godot instance is not running!");
+		}
+		uint32_t capacity = 256;
+		uint32_t blockTimeoutMs = 100;
+		GodotEventStream::OverflowPolicy policy = GodotEventStream::OVERFLOW_DROP_OLDEST;
+		if (count > 0 && args[0].isObject()) {
+			jsi::Object options = args[0].asObject(rt);
+			jsi::Value capacityValue = options.getProperty(rt, "capacity");
+			if (capacityValue.isNumber()) {
+				capacity = readIntegerArg(rt, capacityValue, 1, GodotEventStream::MAX_CAPACITY, "createEventStream", "capacity");
+			}
+			jsi::Value overflowValue = options.getProperty(rt, "overflow");
+			if (overflowValue.isString()) {
+				std::string overflow = overflowValue.asString(rt).utf8(rt);
+				if (!GodotEventStream::parse_policy(overflow, policy)) {
+					throw jsi::JSError(rt, "createEventStream: Unknown overflow policy: " + overflow);
+				}
+			}
+			jsi::Value blockTimeoutValue = options.getProperty(rt, "blockTimeoutMs");
+			if (blockTimeoutValue.isNumber()) {
+				blockTimeoutMs = readIntegerArg(rt, blockTimeoutValue, 0, MAX_BLOCK_TIMEOUT_MS, "createEventStream", "blockTimeoutMs");
+			}
+		}
+		std::shared_ptr<GodotEventStream> stream = std::make_shared<GodotEventStream>(capacity, policy, blockTimeoutMs);
+		return jsi::Object::createFromHostObject(rt, std::make_shared<GodotEventStreamHostObject>(workletContext, stream));
+	};
+	// encodeVariant(value): ArrayBuffer in the format of var_to_bytes()
+	auto encodeVariantFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1) {
+			throw jsi::JSError(rt, "encodeVariant: Expected a value!");
+		}
+		godot::Variant value = GodotHostObject::jsiValueToGodotVariant(workletContext, rt, args[0]);
+		std::vector<uint8_t> bytes;
+		VariantCodec::encode(value, bytes);
+		return jsi::Value(rt, jsi::ArrayBuffer(rt, std::make_shared<ByteVectorBuffer>(std::move(bytes))));
+	};
+
+	// decodeVariant(buffer: ArrayBuffer, offset?: number): Godot value
+	auto decodeVariantFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isObject() || !args[0].asObject(rt).isArrayBuffer(rt)) {
+			throw jsi::JSError(rt, "decodeVariant: First argument has to be an ArrayBuffer!");
+		}
+		jsi::ArrayBuffer buffer = args[0].asObject(rt).getArrayBuffer(rt);
+		size_t offset = 0;
+		if (count > 1 && args[1].isNumber()) {
+			offset = readIntegerArg(rt, args[1], 0, SIZE_MAX, "decodeVariant", "offset");
+		}
+		size_t size = buffer.size(rt);
+		if (offset > size) {
+			throw jsi::JSError(rt, "decodeVariant: Offset is out of bounds!");
+		}
+		godot::Variant value;
+		size_t used = 0;
+		if (!VariantCodec::decode(buffer.data(rt) + offset, size - offset, value, used)) {
+			throw jsi::JSError(rt, "decodeVariant: Invalid or truncated data!");
+		}
+		return GodotHostObject::godotVariantToJsiValue(workletContext, rt, value);
+	};
+
+	// toPackedFloat32Array(source, layout?): PackedFloat32Array
+	auto toPackedFloat32ArrayFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1) {
+			throw jsi::JSError(rt, "toPackedFloat32Array: Expected a source array!");
+		}
+		NumberSource source = readNumberSource(rt, args[0], "toPackedFloat32Array");
+		ArrayLayout layout = readArrayLayout(rt, args, count, 1, source.length, 1, "toPackedFloat32Array");
+		godot::PackedFloat32Array packed;
+		if (layout.count > 0) {
+			packed.resize(layout.count);
+			copyNumbers(source, layout, 1, packed.ptrw());
+		}
+		return GodotHostObject::godotVariantToJsiValue(workletContext, rt, godot::Variant(packed));
+	};
+
+	// toPackedVector3Array(source, layout?): PackedVector3Array from x, y, z triplets
+	auto toPackedVector3ArrayFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1) {
+			throw jsi::JSError(rt, "toPackedVector3Array: Expected a source array!");
+		}
+		NumberSource source = readNumberSource(rt, args[0], "toPackedVector3Array");
+		ArrayLayout layout = readArrayLayout(rt, args, count, 1, source.length, 3, "toPackedVector3Array");
+		godot::PackedVector3Array packed;
+		if (layout.count > 0) {
+			packed.resize(layout.count);
+			copyNumbers(source, layout, 3, (godot::real_t *)packed.ptrw());
+		}
+		return GodotHostObject::godotVariantToJsiValue(workletContext, rt, godot::Variant(packed));
+	};
+
+	// fromPackedArray(packed, { target?, offset?, stride? }): Float64Array
+	auto fromPackedArrayFunc = [workletContext](jsi::Runtime &rt, const jsi::Value &thisVal, const jsi::Value *args, size_t count) {
+		if (count < 1 || !args[0].isObject() || !args[0].asObject(rt).isHostObject<GodotHostObject>(rt)) {
+			throw jsi::JSError(rt, "fromPackedArray: First argument has to be a Godot packed array!");
+		}
+		godot::Variant value = GodotHostObject::jsiValueToGodotVariant(workletContext, rt, args[0]);
+		godot::PackedFloat32Array f32s;
+		godot::PackedFloat64Array f64s;
+		godot::PackedVector2Array v2s;
+		godot::PackedVector3Array v3s;
+		godot::PackedColorArray colors;
+		const float *f32 = nullptr;
+		const double *f64 = nullptr;
+		const godot::real_t *reals = nullptr;
+		size_t components = 1;
+		size_t elements = 0;
+		switch (value.get_type()) {
+			case godot::Variant::Type::PACKED_FLOAT32_ARRAY:
+				f32s = value;
+				f32 = f32s.ptr();
+				elements = f32s.size();
+				break;
+			case godot::Variant::Type::PACKED_FLOAT64_ARRAY:
+				f64s = value;
+				f64 = f64s.ptr();
+				elements = f64s.size();
+				break;
+			case godot::Variant::Type::PACKED_VECTOR2_ARRAY:
+				v2s = value;
+				reals = (const godot::real_t *)v2s.ptr();
+				components = 2;
+				elements = v2s.size();
+				break;
+			case godot::Variant::Type::PACKED_VECTOR3_ARRAY:
+				v3s = value;
+				reals = (const godot::real_t *)v3s.ptr();
+				components = 3;
+				elements = v3s.size();
+				break;
+			case godot::Variant::Type::PACKED_COLOR_ARRAY:
+				colors = value;
+				f32 = (const float *)colors.ptr();
+				components = 4;
+				elements = colors.size();
+				break;
+			default:
+				throw jsi::JSError(rt, "fromPackedArray: Unsupported array type!");
+		}
+		if (reals) {
+#ifdef REAL_T_IS_DOUBLE
+			f64 = reals;
+#else
+			f32 = reals;
+#endif
+		}
+		size_t offset = 0;
+		size_t stride = components;
+		jsi::Value target = jsi::Value::undefined();
+		if (count > 1 && args[1].isObject()) {
+			jsi::Object options = args[1].asObject(rt);
+			target = options.getProperty(rt, "target");
+			readIndexOption(rt, options, "offset", offset, "fromPackedArray");
+			readIndexOption(rt, options, "stride", stride, "fromPackedArray");
+		}
+		if (stride < components) {
+			throw jsi::JSError(rt, "fromPackedArray: Stride is smaller than the element size!");
+		}
+		size_t needed = 0;
+		if (!ArrayKernels::get_extent(offset, stride, elements, components, needed) || needed > SIZE_MAX / sizeof(double)) {
+			throw jsi::JSError(rt, "fromPackedArray: Offset and stride are out of range!");
+		}
+		double *dst = nullptr;
+		jsi::Value result;
+		if (target.isObject()) {
+			jsi::Object targetObj = target.asObject(rt);
+			if (getConstructorName(rt, targetObj) != "Float64Array") {
+				throw jsi::JSError(rt, "fromPackedArray: Target has to be a Float64Array!");
+			}
+			NumberSource view = readNumberSource(rt, target, "fromPackedArray");
+			if (view.length < needed) {
+				throw jsi::JSError(rt, "fromPackedArray: Target is too short!");
+			}
+			dst = const_cast<double *>(view.f64);
+			result = jsi::Value(rt, target);
+		} else {
+			auto buffer = std::make_shared<ByteVectorBuffer>(std::vector<uint8_t>(needed * sizeof(double)));
+			dst = (double *)buffer->data();
+			jsi::ArrayBuffer arrayBuffer(rt, buffer);
+			result = rt.global().getPropertyAsFunction(rt, "Float64Array").callAsConstructor(rt, arrayBuffer);
+		}
+		if (f32) {
+			ArrayKernels::f32_to_f64_strided(f32, components, dst + offset, stride, elements, components);
+		} else {
+			for (size_t e = 0; e < elements; e++) {
+				std::copy_n(f64 + e * components, components, dst + offset + e * stride);
+			}
+		}
+		return result;
+	};
+
 	{
 		jsi::Runtime &workletRT = workletContext->getWorkletRuntime();
 
@@ -813,6 +1870,102 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 				0,
 				destroyInstanceFunc);
 
+		jsi::Function setThreadConfig = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "setThreadConfig"),
+				1,
+				setThreadConfigFunc);
+
+		jsi::Function getThreadStats = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "getThreadStats"),
+				0,
+				getThreadStatsFunc);
+
+		jsi::Function createStateChannel = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "createStateChannel"),
+				2,
+				createStateChannelFunc);
+
+		jsi::Function releaseStateChannel = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "releaseStateChannel"),
+				1,
+				releaseStateChannelFunc);
+
+		jsi::Function createEventStream = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "createEventStream"),
+				1,
+				createEventStreamFunc);
+
+		jsi::Function encodeVariant = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "encodeVariant"),
+				1,
+				encodeVariantFunc);
+
+		jsi::Function decodeVariant = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "decodeVariant"),
+				2,
+				decodeVariantFunc);
+
+		jsi::Function setLogLevel = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "setLogLevel"),
+				1,
+				setLogLevelFunc);
+
+		jsi::Function getLogLevel = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "getLogLevel"),
+				0,
+				getLogLevelFunc);
+
+		jsi::Function toPackedFloat32Array = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "toPackedFloat32Array"),
+				2,
+				toPackedFloat32ArrayFunc);
+
+		jsi::Function toPackedVector3Array = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "toPackedVector3Array"),
+				2,
+				toPackedVector3ArrayFunc);
+
+		jsi::Function fromPackedArray = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "fromPackedArray"),
+				2,
+				fromPackedArrayFunc);
+
+		jsi::Function setBridgeMetricsEnabled = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "setBridgeMetricsEnabled"),
+				1,
+				setBridgeMetricsEnabledFunc);
+
+		jsi::Function getBridgeStats = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "getBridgeStats"),
+				0,
+				getBridgeStatsFunc);
+
+		jsi::Function resetBridgeStats = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "resetBridgeStats"),
+				0,
+				resetBridgeStatsFunc);
+
+		jsi::Function preloadResource = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "preloadResource"),
+				2,
+				preloadResourceFunc);
+
+		jsi::Function setPreloadConfig = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "setPreloadConfig"),
+				1,
+				setPreloadConfigFunc);
+
+		jsi::Function warmUpShaders = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "warmUpShaders"),
+				1,
+				warmUpShadersFunc);
+
+		jsi::Function getShaderCacheStats = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "getShaderCacheStats"),
+				0,
+				getShaderCacheStatsFunc);
+
+		jsi::Function getStartupReport = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "getStartupReport"),
+				0,
+				getStartupReportFunc);
+
+		jsi::Function writeStartupReport = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "writeStartupReport"),
+				1,
+				writeStartupReportFunc);
+
+		jsi::Function setSnapshotConfig = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "setSnapshotConfig"),
+				1,
+				setSnapshotConfigFunc);
+
+		jsi::Function discardSnapshot = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "discardSnapshot"),
+				0,
+				discardSnapshotFunc);
+
+		jsi::Function getFileRoute = jsi::Function::createFromHostFunction(workletRT, jsi::PropNameID::forUtf8(workletRT, "getFileRoute"),
+				2,
+				getFileRouteFunc);
+
 		jsi::Object o(workletRT);
 		// o.setProperty(workletRT, jsi::PropNameID::forUtf8(rt, "runOnGodotThread"), runOnGodotThread);
 		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "createInstance"), createInstance);
@@ -823,13 +1976,37 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "pause"), pause);
 		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "resume"), resume);
 		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "destroyInstance"), destroyInstance);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "setThreadConfig"), setThreadConfig);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "getThreadStats"), getThreadStats);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "createStateChannel"), createStateChannel);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "releaseStateChannel"), releaseStateChannel);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "createEventStream"), createEventStream);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "encodeVariant"), encodeVariant);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "decodeVariant"), decodeVariant);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "setLogLevel"), setLogLevel);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "getLogLevel"), getLogLevel);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "toPackedFloat32Array"), toPackedFloat32Array);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "toPackedVector3Array"), toPackedVector3Array);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "fromPackedArray"), fromPackedArray);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "setBridgeMetricsEnabled"), setBridgeMetricsEnabled);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "getBridgeStats"), getBridgeStats);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "resetBridgeStats"), resetBridgeStats);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "preloadResource"), preloadResource);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "setPreloadConfig"), setPreloadConfig);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "warmUpShaders"), warmUpShaders);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "getShaderCacheStats"), getShaderCacheStats);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "getStartupReport"), getStartupReport);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "writeStartupReport"), writeStartupReport);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "setSnapshotConfig"), setSnapshotConfig);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "discardSnapshot"), discardSnapshot);
+		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "getFileRoute"), getFileRoute);
 		o.setProperty(workletRT, jsi::PropNameID::forUtf8(workletRT, "crash"), crash);
 
 		auto result = jsi::Value(workletRT, o);
 		workletRT.global().setProperty(workletRT, NATIVE_GODOT_MODULE_PROPERTY, result);
 	}
 
-	// runOnGodotThread(run: () => T): Promise<T>
+	// runOnGodotThread(run: () => T, priority?: "urgent" | "frame" | "background"): Promise<T>
 	auto runOnGodotThread = jsi::Function::createFromHostFunction(rt,
 			jsi::PropNameID::forAscii(rt, "runOnGodotThread"),
 			1, // run
@@ -871,6 +2048,102 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 			0,
 			destroyInstanceFunc);
 
+	jsi::Function setThreadConfig = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "setThreadConfig"),
+			1,
+			setThreadConfigFunc);
+
+	jsi::Function getThreadStats = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "getThreadStats"),
+			0,
+			getThreadStatsFunc);
+
+	jsi::Function createStateChannel = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "createStateChannel"),
+			2,
+			createStateChannelFunc);
+
+	jsi::Function releaseStateChannel = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "releaseStateChannel"),
+			1,
+			releaseStateChannelFunc);
+
+	jsi::Function createEventStream = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "createEventStream"),
+			1,
+			createEventStreamFunc);
+
+	jsi::Function encodeVariant = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "encodeVariant"),
+			1,
+			encodeVariantFunc);
+
+	jsi::Function decodeVariant = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "decodeVariant"),
+			2,
+			decodeVariantFunc);
+
+	jsi::Function setLogLevel = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "setLogLevel"),
+			1,
+			setLogLevelFunc);
+
+	jsi::Function getLogLevel = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "getLogLevel"),
+			0,
+			getLogLevelFunc);
+
+	jsi::Function toPackedFloat32Array = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "toPackedFloat32Array"),
+			2,
+			toPackedFloat32ArrayFunc);
+
+	jsi::Function toPackedVector3Array = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "toPackedVector3Array"),
+			2,
+			toPackedVector3ArrayFunc);
+
+	jsi::Function fromPackedArray = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "fromPackedArray"),
+			2,
+			fromPackedArrayFunc);
+
+	jsi::Function setBridgeMetricsEnabled = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "setBridgeMetricsEnabled"),
+			1,
+			setBridgeMetricsEnabledFunc);
+
+	jsi::Function getBridgeStats = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "getBridgeStats"),
+			0,
+			getBridgeStatsFunc);
+
+	jsi::Function resetBridgeStats = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "resetBridgeStats"),
+			0,
+			resetBridgeStatsFunc);
+
+	jsi::Function preloadResource = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "preloadResource"),
+			2,
+			preloadResourceFunc);
+
+	jsi::Function setPreloadConfig = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "setPreloadConfig"),
+			1,
+			setPreloadConfigFunc);
+
+	jsi::Function warmUpShaders = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "warmUpShaders"),
+			1,
+			warmUpShadersFunc);
+
+	jsi::Function getShaderCacheStats = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "getShaderCacheStats"),
+			0,
+			getShaderCacheStatsFunc);
+
+	jsi::Function getStartupReport = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "getStartupReport"),
+			0,
+			getStartupReportFunc);
+
+	jsi::Function writeStartupReport = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "writeStartupReport"),
+			1,
+			writeStartupReportFunc);
+
+	jsi::Function setSnapshotConfig = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "setSnapshotConfig"),
+			1,
+			setSnapshotConfigFunc);
+
+	jsi::Function discardSnapshot = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "discardSnapshot"),
+			0,
+			discardSnapshotFunc);
+
+	jsi::Function getFileRoute = jsi::Function::createFromHostFunction(rt, jsi::PropNameID::forUtf8(rt, "getFileRoute"),
+			2,
+			getFileRouteFunc);
+
 	jsi::Object o(rt);
 	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "runOnGodotThread"), runOnGodotThread);
 	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "createInstance"), createInstance);
@@ -881,6 +2154,30 @@ jsi::Value createNativeGodotModule(jsi::Runtime &rt, const std::shared_ptr<faceb
 	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "pause"), pause);
 	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "is_paused"), is_paused);
 	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "destroyInstance"), destroyInstance);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "setThreadConfig"), setThreadConfig);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "getThreadStats"), getThreadStats);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "createStateChannel"), createStateChannel);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "releaseStateChannel"), releaseStateChannel);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "createEventStream"), createEventStream);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "encodeVariant"), encodeVariant);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "decodeVariant"), decodeVariant);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "setLogLevel"), setLogLevel);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "getLogLevel"), getLogLevel);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "toPackedFloat32Array"), toPackedFloat32Array);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "toPackedVector3Array"), toPackedVector3Array);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "fromPackedArray"), fromPackedArray);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "setBridgeMetricsEnabled"), setBridgeMetricsEnabled);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "getBridgeStats"), getBridgeStats);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "resetBridgeStats"), resetBridgeStats);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "preloadResource"), preloadResource);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "setPreloadConfig"), setPreloadConfig);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "warmUpShaders"), warmUpShaders);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "getShaderCacheStats"), getShaderCacheStats);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "getStartupReport"), getStartupReport);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "writeStartupReport"), writeStartupReport);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "setSnapshotConfig"), setSnapshotConfig);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "discardSnapshot"), discardSnapshot);
+	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "getFileRoute"), getFileRoute);
 	o.setProperty(rt, jsi::PropNameID::forUtf8(rt, "crash"), crash);
 
 	auto result = jsi::Value(rt, o);
@@ -0,0 +1,208 @@
+/**************************************************************************/
+/*  ResourcePreloader.cpp                                                 */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ResourcePreloader.h"
+#define LOG_TAG "ResourcePreloader"
+#include "godot-log.h"
+
+#include "FileRoute.h"
+
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/variant/array.hpp>
+
+#include <algorithm>
+
+// How often the active loads are polled for progress.
+static constexpr std::chrono::milliseconds POLL_INTERVAL(16);
+
+ResourcePreloader *ResourcePreloader::get_singleton() {
+	static ResourcePreloader *singleton = new ResourcePreloader();
+	return singleton;
+}
+
+bool ResourcePreloader::has_queued() const {
+	for (int i = 0; i < PRIORITY_MAX; i++) {
+		if (!_queued[i].empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ResourcePreloader::request(std::shared_ptr<Request> p_request) {
+	if (FileRoute::get_file_route(p_request->path) == FileRoute::ROUTE_JAVA) {
+		LOGW("%s is read through the Java FileAccessHandler, one JNI call per read. Preload from res:// or user:// instead.", p_request->path.c_str());
+	}
+	p_request->queued_at = Clock::now();
+	p_request->status = STATUS_QUEUED;
+	std::lock_guard lock(_mutex);
+	_queued[p_request->priority].push_back(std::move(p_request));
+	_stats.requested++;
+	if (!_started) {
+		// The poller lives as long as the process, like the singleton.
+		std::thread(&ResourcePreloader::run, this).detach();
+		_started = true;
+	}
+	_cv.notify_one();
+}
+
+void ResourcePreloader::set_max_concurrent(uint32_t p_max_concurrent) {
+	std::lock_guard lock(_mutex);
+	_max_concurrent = std::max(p_max_concurrent, 1u);
+	_cv.notify_one();
+}
+
+uint32_t ResourcePreloader::get_max_concurrent() {
+	std::lock_guard lock(_mutex);
+	return _max_concurrent;
+}
+
+void ResourcePreloader::start_queued(std::vector<Finished> &r_finished) {
+	godot::ResourceLoader *loader = godot::ResourceLoader::get_singleton();
+	for (int i = 0; i < PRIORITY_MAX && _active.size() < _max_concurrent; i++) {
+		std::deque<std::shared_ptr<Request>> &queue = _queued[i];
+		while (!queue.empty() && _active.size() < _max_concurrent) {
+			std::shared_ptr<Request> request = std::move(queue.front());
+			queue.pop_front();
+			request->started_at = Clock::now();
+			_stats.total_wait_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(request->started_at - request->queued_at).count();
+			godot::Error err = loader->load_threaded_request(request->path.c_str(), request->type_hint.c_str(), request->use_sub_threads);
+			if (err != godot::OK) {
+				std::string error = "Unable to request " + request->path + " (error " + std::to_string((int)err) + ")";
+				r_finished.push_back({ std::move(request), godot::Ref<godot::Resource>(), std::move(error) });
+				continue;
+			}
+			request->status = STATUS_LOADING;
+			_active.push_back(std::move(request));
+		}
+	}
+}
+
+void ResourcePreloader::poll_active(std::vector<Finished> &r_finished) {
+	godot::ResourceLoader *loader = godot::ResourceLoader::get_singleton();
+	godot::Array progress;
+	progress.resize(1);
+	auto it = _active.begin();
+	while (it != _active.end()) {
+		std::shared_ptr<Request> &request = *it;
+		godot::String path = request->path.c_str();
+		godot::ResourceLoader::ThreadLoadStatus status = loader->load_threaded_get_status(path, progress);
+		if (status == godot::ResourceLoader::THREAD_LOAD_IN_PROGRESS) {
+			request->progress = (float)progress[0];
+			++it;
+			continue;
+		}
+		godot::Ref<godot::Resource> resource;
+		if (status == godot::ResourceLoader::THREAD_LOAD_LOADED) {
+			resource = loader->load_threaded_get(path);
+		}
+		std::string error = resource.is_valid() ? std::string() : "Unable to load " + request->path;
+		r_finished.push_back({ std::move(request), resource, std::move(error) });
+		it = _active.erase(it);
+	}
+}
+
+void ResourcePreloader::finish(Finished &p_finished) {
+	Request &request = *p_finished.request;
+	if (p_finished.error.empty()) {
+		uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - request.started_at).count();
+		request.load_ns = ns;
+		request.progress = 1.0f;
+		request.status = STATUS_LOADED;
+		_stats.loaded++;
+		_stats.total_load_ns += ns;
+		_stats.max_load_ns = std::max(_stats.max_load_ns, ns);
+		_stats.last_load_ns = ns;
+	} else {
+		request.status = STATUS_FAILED;
+		_stats.failed++;
+	}
+}
+
+void ResourcePreloader::run() {
+	std::vector<Finished> finished;
+	std::unique_lock lock(_mutex);
+	while (true) {
+		_cv.wait(lock, [this] { return !_active.empty() || (has_queued() && _active.size() < _max_concurrent); });
+
+		start_queued(finished);
+		poll_active(finished);
+		for (Finished &f : finished) {
+			finish(f);
+		}
+
+		if (!finished.empty()) {
+			// The callbacks may queue new requests.
+			lock.unlock();
+			for (Finished &f : finished) {
+				if (!f.error.empty()) {
+					LOGE("%s", f.error.c_str());
+				}
+				f.request->on_done(f.resource, f.error);
+			}
+			finished.clear();
+			lock.lock();
+		}
+
+		if (!_active.empty()) {
+			_cv.wait_for(lock, POLL_INTERVAL);
+		}
+	}
+}
+
+void ResourcePreloader::fail_all(const std::string &p_error) {
+	std::vector<Finished> failed;
+	{
+		std::lock_guard lock(_mutex);
+		for (int i = 0; i < PRIORITY_MAX; i++) {
+			for (std::shared_ptr<Request> &request : _queued[i]) {
+				failed.push_back({ std::move(request), godot::Ref<godot::Resource>(), p_error });
+			}
+			_queued[i].clear();
+		}
+		for (std::shared_ptr<Request> &request : _active) {
+			failed.push_back({ std::move(request), godot::Ref<godot::Resource>(), p_error });
+		}
+		_active.clear();
+		for (Finished &f : failed) {
+			finish(f);
+		}
+	}
+	for (Finished &f : failed) {
+		f.request->on_done(f.resource, f.error);
+	}
+}
+
+ResourcePreloader::Stats ResourcePreloader::get_stats() {
+	std::lock_guard lock(_mutex);
+	Stats stats = _stats;
+	stats.active = (uint32_t)_active.size();
+	stats.queued = 0;
+	for (int i = 0; i < PRIORITY_MAX; i++) {
+		stats.queued += (uint32_t)_queued[i].size();
+	}
+	stats.max_concurrent = _max_concurrent;
+	return stats;
+}
@@ -0,0 +1,136 @@
+/**************************************************************************/
+/*  ResourcePreloader.h                                                   */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/classes/ref.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loads resources in the background with ResourceLoader's threaded loader.
+//
+// Requests wait in one queue per priority until one of the max_concurrent
+// load slots is free, then they are handed to load_threaded_request(). A
+// poller thread checks the active loads every few milliseconds, publishes
+// their progress and calls the completion callback of a request from the
+// poller thread once it is loaded or failed.
+class ResourcePreloader {
+public:
+	enum Priority {
+		PRIORITY_HIGH,
+		PRIORITY_NORMAL,
+		PRIORITY_LOW,
+		PRIORITY_MAX,
+	};
+
+	enum Status {
+		STATUS_QUEUED,
+		STATUS_LOADING,
+		STATUS_LOADED,
+		STATUS_FAILED,
+	};
+
+	using Clock = std::chrono::steady_clock;
+	using Callback = std::function<void(godot::Ref<godot::Resource> p_resource, const std::string &p_error)>;
+
+	struct Request {
+		std::string path;
+		std::string type_hint;
+		bool use_sub_threads = false;
+		Priority priority = PRIORITY_NORMAL;
+		Callback on_done;
+
+		// Written by the poller, can be read from any thread.
+		std::atomic<float> progress = 0.0f;
+		std::atomic<int> status = STATUS_QUEUED;
+		std::atomic<uint64_t> load_ns = 0;
+
+		Clock::time_point queued_at;
+		Clock::time_point started_at;
+	};
+
+	struct Stats {
+		uint64_t requested = 0;
+		uint64_t loaded = 0;
+		uint64_t failed = 0;
+		uint32_t active = 0;
+		uint32_t queued = 0;
+		uint32_t max_concurrent = 0;
+		uint64_t total_load_ns = 0;
+		uint64_t max_load_ns = 0;
+		uint64_t last_load_ns = 0;
+		uint64_t total_wait_ns = 0;
+	};
+
+private:
+	struct Finished {
+		std::shared_ptr<Request> request;
+		godot::Ref<godot::Resource> resource;
+		std::string error;
+	};
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	bool _started = false;
+	std::deque<std::shared_ptr<Request>> _queued[PRIORITY_MAX];
+	std::vector<std::shared_ptr<Request>> _active;
+	uint32_t _max_concurrent = 2;
+	Stats _stats;
+
+	ResourcePreloader() {}
+
+	bool has_queued() const;
+	void start_queued(std::vector<Finished> &r_finished);
+	void poll_active(std::vector<Finished> &r_finished);
+	void finish(Finished &p_finished);
+	void run();
+
+public:
+	static ResourcePreloader *get_singleton();
+
+	// Queues the request, its callback is called exactly once.
+	void request(std::shared_ptr<Request> p_request);
+
+	// Number of loads handed to ResourceLoader at the same time, at least 1.
+	void set_max_concurrent(uint32_t p_max_concurrent);
+	uint32_t get_max_concurrent();
+
+	// Fails all queued and active requests, e.g. before the instance is destroyed.
+	// Once it returns the poller does not call into Godot until the next request.
+	void fail_all(const std::string &p_error);
+
+	Stats get_stats();
+};
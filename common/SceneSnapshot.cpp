@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*  SceneSnapshot.cpp                                                     */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "SceneSnapshot.h"
+#define LOG_TAG "SceneSnapshot"
+#include "godot-log.h"
+
+#include "StartupTrace.h"
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/packed_scene.hpp>
+#include <godot_cpp/classes/resource_saver.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <sys/stat.h>
+#include <thread>
+
+// Serializes writers when the app is paused again before a save finished.
+static std::mutex saveMutex;
+
+void SceneSnapshot::set_path(const std::string &p_path) {
+	std::lock_guard lock(_mutex);
+	_path = p_path;
+}
+
+std::string SceneSnapshot::get_path() {
+	std::lock_guard lock(_mutex);
+	return _path;
+}
+
+bool SceneSnapshot::apply(std::vector<std::string> &r_args) {
+	std::string path = get_path();
+	struct stat st;
+	bool found = !path.empty() && stat(path.c_str(), &st) == 0;
+	if (found) {
+		// A scene path on the command line replaces the main scene.
+		r_args.push_back(path);
+		LOGI("Starting from snapshot %s", path.c_str());
+	}
+	StartupTrace::set_from_snapshot(found);
+	return found;
+}
+
+// Nodes added at runtime have no owner, PackedScene::pack() would skip them.
+static void adopt(godot::Node *p_root, godot::Node *p_node, std::vector<godot::Node *> &r_adopted) {
+	for (int64_t i = 0; i < p_node->get_child_count(); i++) {
+		godot::Node *child = p_node->get_child(i);
+		if (!child->get_owner()) {
+			child->set_owner(p_root);
+			r_adopted.push_back(child);
+		}
+		// Nodes of instanced scenes keep their owner and come from their scene file.
+		adopt(p_root, child, r_adopted);
+	}
+}
+
+void SceneSnapshot::capture(std::function<void()> p_done) {
+	std::string path = get_path();
+	godot::SceneTree *sceneTree = godot::Object::cast_to<godot::SceneTree>(godot::Engine::get_singleton()->get_main_loop());
+	godot::Node *scene = sceneTree ? sceneTree->get_current_scene() : nullptr;
+	if (path.empty() || !scene) {
+		if (p_done) {
+			p_done();
+		}
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<godot::Node *> adopted;
+	adopt(scene, scene, adopted);
+	godot::Ref<godot::PackedScene> packed;
+	packed.instantiate();
+	godot::Error err = packed->pack(scene);
+	for (godot::Node *node : adopted) {
+		node->set_owner(nullptr);
+	}
+	if (err != godot::OK) {
+		LOGE("Unable to pack the current scene (error %d)", (int)err);
+		if (p_done) {
+			p_done();
+		}
+		return;
+	}
+	LOGI("Packed snapshot in %lld us", (long long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+	{
+		std::lock_guard lock(_mutex);
+		_saves_in_flight++;
+	}
+	std::thread([packed, path, p_done]() mutable {
+		{
+			std::lock_guard lock(saveMutex);
+			// Written next to the target and renamed, a killed process never leaves a partial snapshot.
+			std::string tmp = path + ".tmp.scn";
+			godot::Error err = godot::ResourceSaver::get_singleton()->save(packed, tmp.c_str());
+			if (err != godot::OK || std::rename(tmp.c_str(), path.c_str()) != 0) {
+				LOGE("Unable to write snapshot %s (error %d)", path.c_str(), (int)err);
+				std::remove(tmp.c_str());
+			}
+			// Released before the save counts as finished, it calls into Godot too.
+			packed.unref();
+		}
+		if (p_done) {
+			p_done();
+		}
+		{
+			std::lock_guard lock(_mutex);
+			_saves_in_flight--;
+		}
+		_saves_done.notify_all();
+	}).detach();
+}
+
+void SceneSnapshot::wait_for_saves() {
+	std::unique_lock lock(_mutex);
+	if (_saves_in_flight > 0) {
+		LOGI("Waiting for %d snapshot saves", _saves_in_flight);
+	}
+	_saves_done.wait(lock, []() { return _saves_in_flight == 0; });
+}
+
+void SceneSnapshot::discard() {
+	std::string path = get_path();
+	if (!path.empty()) {
+		std::lock_guard lock(saveMutex);
+		std::remove(path.c_str());
+	}
+}
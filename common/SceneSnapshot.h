@@ -0,0 +1,69 @@
+/**************************************************************************/
+/*  SceneSnapshot.h                                                       */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Saves the current scene as a PackedScene when the app goes to the
+// background, and starts the next instance from it instead of the main
+// scene, e.g. after Android killed the process.
+//
+// Only what a PackedScene stores survives: the nodes of the current scene
+// and their stored properties. Autoloads and other state outside the
+// scene start fresh.
+class SceneSnapshot {
+	static inline std::mutex _mutex;
+	static inline std::string _path;
+	// Saves still running on their background thread, see wait_for_saves().
+	static inline int _saves_in_flight = 0;
+	static inline std::condition_variable _saves_done;
+
+	static std::string get_path();
+
+public:
+	// Absolute path of the .scn file, empty disables snapshots.
+	static void set_path(const std::string &p_path);
+
+	// Adds the snapshot to the command line of a new instance if there is one.
+	// Returns true if the instance will start from the snapshot.
+	static bool apply(std::vector<std::string> &r_args);
+
+	// Packs the current scene on the Godot thread and saves it on a
+	// background thread. p_done, if set, is called once the file is written
+	// or when there is nothing to save.
+	static void capture(std::function<void()> p_done = nullptr);
+
+	// Blocks until the saves started by capture() finished. They call into
+	// Godot, so destroying the instance has to wait for them.
+	static void wait_for_saves();
+
+	// Removes the snapshot, e.g. when the game state is reset.
+	static void discard();
+};
@@ -0,0 +1,197 @@
+/**************************************************************************/
+/*  ShaderCache.cpp                                                       */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ShaderCache.h"
+#define LOG_TAG "ShaderCache"
+#include "godot-log.h"
+
+#include "GodotModule.h"
+#include <godot_cpp/classes/base_material3d.hpp>
+#include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/classes/canvas_item_material.hpp>
+#include <godot_cpp/classes/color_rect.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/geometry_instance3d.hpp>
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/packed_scene.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/quad_mesh.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/shader.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
+#include <godot_cpp/classes/sub_viewport.hpp>
+#include <godot_cpp/classes/window.hpp>
+
+#include <chrono>
+
+// Where the shader compilers and the RenderingDevice pipeline cache store
+// their files.
+static const char *CACHE_DIRS[] = { "user://shader_cache", "user://vulkan" };
+
+static ShaderCache::Stats stats;
+
+static void scan_dir(const godot::String &p_path, uint64_t &r_bytes, uint32_t &r_files) {
+	godot::Ref<godot::DirAccess> dir = godot::DirAccess::open(p_path);
+	if (dir.is_null()) {
+		return;
+	}
+	godot::PackedStringArray files = dir->get_files();
+	for (int64_t i = 0; i < files.size(); i++) {
+		godot::Ref<godot::FileAccess> file = godot::FileAccess::open(p_path.path_join(files[i]), godot::FileAccess::READ);
+		if (file.is_valid()) {
+			r_bytes += file->get_length();
+		}
+		r_files++;
+	}
+	godot::PackedStringArray dirs = dir->get_directories();
+	for (int64_t i = 0; i < dirs.size(); i++) {
+		scan_dir(p_path.path_join(dirs[i]), r_bytes, r_files);
+	}
+}
+
+void ShaderCache::record_baseline() {
+	Stats current = get_stats();
+	stats.files_at_start = current.files;
+	if (!current.enabled) {
+		LOGW("rendering/shader_compiler/shader_cache/enabled is off, shaders are compiled on every launch");
+	}
+	LOGI("Shader cache: %u files, %llu bytes", current.files, (unsigned long long)current.bytes);
+}
+
+ShaderCache::Stats ShaderCache::get_stats() {
+	Stats result = stats;
+	result.enabled = godot::ProjectSettings::get_singleton()->get_setting("rendering/shader_compiler/shader_cache/enabled", true);
+	result.bytes = 0;
+	result.files = 0;
+	for (const char *dir : CACHE_DIRS) {
+		scan_dir(dir, result.bytes, result.files);
+	}
+	return result;
+}
+
+// Makes the geometry of an instantiated scene pass frustum culling, so all of
+// it is drawn from the warm-up camera.
+static void disable_culling(godot::Node *p_node) {
+	if (godot::GeometryInstance3D *geometry = godot::Object::cast_to<godot::GeometryInstance3D>(p_node)) {
+		geometry->set_extra_cull_margin(16384.0);
+	}
+	for (int64_t i = 0; i < p_node->get_child_count(); i++) {
+		disable_culling(p_node->get_child(i));
+	}
+}
+
+static bool add_material(godot::SubViewport *p_viewport, const godot::Ref<godot::Material> &p_material) {
+	bool canvas = false;
+	godot::Ref<godot::ShaderMaterial> shaderMaterial = p_material;
+	if (shaderMaterial.is_valid()) {
+		godot::Ref<godot::Shader> shader = shaderMaterial->get_shader();
+		if (shader.is_null()) {
+			return false;
+		}
+		godot::Shader::Mode mode = shader->get_mode();
+		if (mode == godot::Shader::MODE_CANVAS_ITEM) {
+			canvas = true;
+		} else if (mode != godot::Shader::MODE_SPATIAL) {
+			return false;
+		}
+	} else if (godot::Object::cast_to<godot::CanvasItemMaterial>(p_material.ptr())) {
+		canvas = true;
+	} else if (!godot::Object::cast_to<godot::BaseMaterial3D>(p_material.ptr())) {
+		return false;
+	}
+
+	if (canvas) {
+		godot::ColorRect *rect = memnew(godot::ColorRect);
+		rect->set_size(godot::Vector2(16, 16));
+		rect->set_material(p_material);
+		p_viewport->add_child(rect);
+	} else {
+		godot::Ref<godot::QuadMesh> quad;
+		quad.instantiate();
+		godot::MeshInstance3D *mesh = memnew(godot::MeshInstance3D);
+		mesh->set_mesh(quad);
+		mesh->set_material_override(p_material);
+		p_viewport->add_child(mesh);
+	}
+	return true;
+}
+
+void ShaderCache::warm_up(const std::vector<godot::Ref<godot::Resource>> &p_resources, std::function<void(uint32_t p_drawn)> p_done) {
+	godot::SceneTree *sceneTree = godot::Object::cast_to<godot::SceneTree>(godot::Engine::get_singleton()->get_main_loop());
+	if (!sceneTree || p_resources.empty()) {
+		p_done(0);
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	godot::SubViewport *viewport = memnew(godot::SubViewport);
+	viewport->set_size(godot::Vector2i(64, 64));
+	viewport->set_update_mode(godot::SubViewport::UPDATE_ALWAYS);
+	viewport->set_use_own_world_3d(true);
+	godot::Camera3D *camera = memnew(godot::Camera3D);
+	camera->set_position(godot::Vector3(0, 0, 2));
+	viewport->add_child(camera);
+
+	uint32_t drawn = 0;
+	for (const godot::Ref<godot::Resource> &resource : p_resources) {
+		godot::Ref<godot::PackedScene> scene = resource;
+		godot::Ref<godot::Material> material = resource;
+		if (scene.is_valid()) {
+			godot::Node *node = scene->instantiate();
+			if (node) {
+				disable_culling(node);
+				viewport->add_child(node);
+				drawn++;
+				continue;
+			}
+		} else if (material.is_valid() && add_material(viewport, material)) {
+			drawn++;
+			continue;
+		}
+		LOGW("Unable to warm up %s", resource->get_path().utf8().get_data());
+	}
+
+	sceneTree->get_root()->add_child(viewport);
+	camera->make_current();
+
+	// Compiling happens while the viewport is drawn, so the next
+	// frame_post_draw marks the end of the warm-up.
+	uint64_t viewportId = viewport->get_instance_id();
+	godot::Callable callable = GodotModule::get_singleton()->create_callable([viewportId, drawn, start, p_done](const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) {
+		if (godot::Node *node = godot::Object::cast_to<godot::Node>(godot::ObjectDB::get_instance(viewportId))) {
+			node->queue_free();
+		}
+		uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		stats.warm_ups++;
+		stats.warmed += drawn;
+		stats.warm_up_ns += ns;
+		LOGI("Warmed up %u resources in %llu ms", drawn, (unsigned long long)(ns / 1000000));
+		p_done(drawn);
+	});
+	godot::RenderingServer::get_singleton()->connect("frame_post_draw", callable, godot::Object::CONNECT_ONE_SHOT);
+}
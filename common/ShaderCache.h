@@ -0,0 +1,62 @@
+/**************************************************************************/
+/*  ShaderCache.h                                                         */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <godot_cpp/classes/ref.hpp>
+#include <godot_cpp/classes/resource.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Reports the shader and pipeline caches the renderer keeps in user://,
+// and warms them up by drawing resources once in an offscreen viewport.
+// All methods must be called on the Godot thread.
+class ShaderCache {
+public:
+	struct Stats {
+		bool enabled = false;
+		uint64_t bytes = 0;
+		uint32_t files = 0;
+		// Files found when the instance started, entries added since then
+		// are shaders or pipelines that had to be compiled.
+		uint32_t files_at_start = 0;
+		uint32_t warm_ups = 0;
+		uint32_t warmed = 0;
+		uint64_t warm_up_ns = 0;
+	};
+
+	// Remembers the cache contents at startup, called once the instance runs.
+	static void record_baseline();
+
+	static Stats get_stats();
+
+	// Draws the given scenes and materials once in a hidden viewport, so their
+	// shaders and pipelines are compiled (or loaded from the cache) before the
+	// app shows them. p_done is called after the frame is drawn, with the
+	// number of resources that could be drawn.
+	static void warm_up(const std::vector<godot::Ref<godot::Resource>> &p_resources, std::function<void(uint32_t p_drawn)> p_done);
+};
@@ -0,0 +1,105 @@
+/**************************************************************************/
+/*  StartupTrace.cpp                                                      */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "StartupTrace.h"
+#define LOG_TAG "StartupTrace"
+#include "godot-log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+static const char *PHASE_NAMES[STARTUP_PHASE_MAX] = {
+	"libraryLoaded",
+	"instanceCreated",
+	"surfaceCreated",
+	"instanceStarted",
+	"firstFrameCallback",
+	"firstIteration",
+};
+
+uint64_t StartupTrace::now_ns() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void StartupTrace::begin() {
+	for (int i = 0; i < STARTUP_PHASE_MAX; i++) {
+		_phase_ns[i].store(0, std::memory_order_relaxed);
+	}
+	_begin_ns.store(now_ns(), std::memory_order_release);
+}
+
+void StartupTrace::mark_slow(StartupPhase p_phase) {
+	uint64_t begin = _begin_ns.load(std::memory_order_acquire);
+	if (begin == 0) {
+		return;
+	}
+	// Never store 0, it means not reached.
+	uint64_t elapsed = std::max<uint64_t>(now_ns() - begin, 1);
+	uint64_t expected = 0;
+	if (_phase_ns[p_phase].compare_exchange_strong(expected, elapsed) && p_phase == STARTUP_FIRST_ITERATION) {
+		log_report();
+	}
+}
+
+StartupTrace::Report StartupTrace::get_report() {
+	Report report;
+	report.begin_ns = _begin_ns.load(std::memory_order_acquire);
+	report.from_snapshot = _from_snapshot.load(std::memory_order_relaxed);
+	for (int i = 0; i < STARTUP_PHASE_MAX; i++) {
+		report.phase_ns[i] = _phase_ns[i].load(std::memory_order_relaxed);
+	}
+	return report;
+}
+
+const char *StartupTrace::get_name(StartupPhase p_phase) {
+	return PHASE_NAMES[p_phase];
+}
+
+void StartupTrace::log_report() {
+	Report report = get_report();
+	std::string line;
+	for (int i = 0; i < STARTUP_PHASE_MAX; i++) {
+		char buf[64];
+		snprintf(buf, sizeof(buf), "%s%s %.1f ms", i ? ", " : "", PHASE_NAMES[i], report.phase_ns[i] / 1e6);
+		line += buf;
+	}
+	LOGI("Startup%s: %s", report.from_snapshot ? " (snapshot)" : "", line.c_str());
+}
+
+bool StartupTrace::write(const std::string &p_path) {
+	Report report = get_report();
+	FILE *f = fopen(p_path.c_str(), "w");
+	if (!f) {
+		LOGE("Unable to write startup report to %s", p_path.c_str());
+		return false;
+	}
+	fprintf(f, "{\"beginNs\":%llu,\"fromSnapshot\":%s,\"phasesNs\":{", (unsigned long long)report.begin_ns, report.from_snapshot ? "true" : "false");
+	for (int i = 0; i < STARTUP_PHASE_MAX; i++) {
+		fprintf(f, "%s\"%s\":%llu", i ? "," : "", PHASE_NAMES[i], (unsigned long long)report.phase_ns[i]);
+	}
+	fprintf(f, "}}\n");
+	return fclose(f) == 0;
+}
@@ -0,0 +1,90 @@
+/**************************************************************************/
+/*  StartupTrace.h                                                        */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+enum StartupPhase {
+	STARTUP_LIBRARY_LOADED, // libgodot opened and its entry point resolved.
+	STARTUP_INSTANCE_CREATED, // libgodot_create_godot_instance returned.
+	STARTUP_SURFACE_CREATED, // Main rendering surface handed to the display server.
+	STARTUP_INSTANCE_STARTED, // GodotInstance::start() returned, the main scene is loaded.
+	STARTUP_FIRST_FRAME_CALLBACK, // First vsync callback of the platform frame loop.
+	STARTUP_FIRST_ITERATION, // First GodotInstance::iteration() completed.
+	STARTUP_PHASE_MAX,
+};
+
+// Monotonic timestamps of the startup phases, from the moment
+// get_or_create_instance() starts creating an instance up to the first
+// completed frame. Each phase is recorded once per instance, mark() returns
+// after one load for a phase that was already recorded. Frame loops check
+// is_finished() once per frame instead.
+class StartupTrace {
+	static inline std::atomic<uint64_t> _begin_ns = 0;
+	static inline std::atomic<uint64_t> _phase_ns[STARTUP_PHASE_MAX] = {};
+	static inline std::atomic<bool> _from_snapshot = false;
+
+	static void mark_slow(StartupPhase p_phase);
+	static void log_report();
+
+public:
+	struct Report {
+		// steady_clock time of begin(), in nanoseconds.
+		uint64_t begin_ns = 0;
+		// Time since begin() for each phase, 0 if not reached yet.
+		uint64_t phase_ns[STARTUP_PHASE_MAX] = {};
+		// The instance started from a scene snapshot instead of the main scene.
+		bool from_snapshot = false;
+	};
+
+	static uint64_t now_ns();
+
+	// Starts a new trace, called when creating an instance begins.
+	static void begin();
+
+	static void mark(StartupPhase p_phase) {
+		if (_phase_ns[p_phase].load(std::memory_order_relaxed) == 0) {
+			mark_slow(p_phase);
+		}
+	}
+
+	// Whether the last phase of the current trace was recorded.
+	static bool is_finished() {
+		return _phase_ns[STARTUP_FIRST_ITERATION].load(std::memory_order_relaxed) != 0;
+	}
+
+	static void set_from_snapshot(bool p_from_snapshot) {
+		_from_snapshot.store(p_from_snapshot, std::memory_order_relaxed);
+	}
+
+	static Report get_report();
+	static const char *get_name(StartupPhase p_phase);
+
+	// Writes the report as JSON, returns false if the file cannot be written.
+	static bool write(const std::string &p_path);
+};
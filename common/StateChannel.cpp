@@ -0,0 +1,221 @@
+/**************************************************************************/
+/*  StateChannel.cpp                                                      */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "StateChannel.h"
+#define LOG_TAG "StateChannel"
+#include "godot-log.h"
+
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/vector2.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+#include <cstring>
+#include <thread>
+
+static const int MAX_READ_ATTEMPTS = 64;
+
+std::mutex StateChannel::_registry_mutex;
+std::map<std::string, std::shared_ptr<StateChannel>> StateChannel::_registry;
+
+static const char *FIELD_TYPE_NAMES[StateChannel::FIELD_MAX] = {
+	"bool",
+	"i32",
+	"u32",
+	"f32",
+	"f64",
+	"vec2",
+	"vec3",
+	"color",
+};
+
+static const uint32_t FIELD_TYPE_SIZES[StateChannel::FIELD_MAX] = {
+	4,
+	4,
+	4,
+	4,
+	8,
+	8,
+	12,
+	16,
+};
+
+bool StateChannel::parse_field_type(const std::string &p_type, FieldType &r_type) {
+	for (int i = 0; i < FIELD_MAX; ++i) {
+		if (p_type == FIELD_TYPE_NAMES[i]) {
+			r_type = (FieldType)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+const char *StateChannel::get_field_type_name(FieldType p_type) {
+	return FIELD_TYPE_NAMES[p_type];
+}
+
+StateChannel::StateChannel(const std::string &p_name, const std::vector<std::pair<std::string, FieldType>> &p_layout) :
+		_name(p_name) {
+	uint32_t offset = HEADER_SIZE;
+	for (const std::pair<std::string, FieldType> &entry : p_layout) {
+		uint32_t align = entry.second == FIELD_FLOAT64 ? 8 : 4;
+		offset = (offset + align - 1) & ~(align - 1);
+		_fields.push_back(Field{ entry.first, entry.second, offset });
+		_keys.push_back(godot::String::utf8(entry.first.c_str()));
+		offset += FIELD_TYPE_SIZES[entry.second];
+	}
+	_size = (offset + 7) & ~7;
+	_storage.reset(new uint64_t[_size / 8]());
+	new (_storage.get()) std::atomic<uint32_t>(0);
+}
+
+std::shared_ptr<StateChannel> StateChannel::get_or_create(const std::string &p_name, const std::vector<std::pair<std::string, FieldType>> &p_layout) {
+	std::lock_guard lock(_registry_mutex);
+	auto it = _registry.find(p_name);
+	if (it != _registry.end()) {
+		const std::vector<Field> &fields = it->second->_fields;
+		bool same = fields.size() == p_layout.size();
+		for (size_t i = 0; same && i < fields.size(); ++i) {
+			same = fields[i].name == p_layout[i].first && fields[i].type == p_layout[i].second;
+		}
+		if (!same) {
+			LOGE("State channel %s already exists with a different layout", p_name.c_str());
+			return nullptr;
+		}
+		return it->second;
+	}
+	std::shared_ptr<StateChannel> channel(new StateChannel(p_name, p_layout));
+	_registry[p_name] = channel;
+	return channel;
+}
+
+void StateChannel::release(const std::string &p_name) {
+	std::lock_guard lock(_registry_mutex);
+	_registry.erase(p_name);
+}
+
+bool StateChannel::write_field(const Field &p_field, const godot::Variant &p_value) {
+	uint8_t *ptr = get_data() + p_field.offset;
+	switch (p_field.type) {
+		case FIELD_BOOL: {
+			uint32_t v = p_value.booleanize() ? 1 : 0;
+			memcpy(ptr, &v, sizeof(v));
+		} break;
+		case FIELD_INT32: {
+			int32_t v = (int64_t)p_value;
+			memcpy(ptr, &v, sizeof(v));
+		} break;
+		case FIELD_UINT32: {
+			uint32_t v = (int64_t)p_value;
+			memcpy(ptr, &v, sizeof(v));
+		} break;
+		case FIELD_FLOAT32: {
+			float v = (double)p_value;
+			memcpy(ptr, &v, sizeof(v));
+		} break;
+		case FIELD_FLOAT64: {
+			double v = p_value;
+			memcpy(ptr, &v, sizeof(v));
+		} break;
+		case FIELD_VECTOR2: {
+			if (p_value.get_type() != godot::Variant::VECTOR2 && p_value.get_type() != godot::Variant::VECTOR2I) {
+				return false;
+			}
+			godot::Vector2 v2 = p_value;
+			float v[2] = { (float)v2.x, (float)v2.y };
+			memcpy(ptr, v, sizeof(v));
+		} break;
+		case FIELD_VECTOR3: {
+			if (p_value.get_type() != godot::Variant::VECTOR3 && p_value.get_type() != godot::Variant::VECTOR3I) {
+				return false;
+			}
+			godot::Vector3 v3 = p_value;
+			float v[3] = { (float)v3.x, (float)v3.y, (float)v3.z };
+			memcpy(ptr, v, sizeof(v));
+		} break;
+		case FIELD_COLOR: {
+			if (p_value.get_type() != godot::Variant::COLOR) {
+				return false;
+			}
+			godot::Color c = p_value;
+			float v[4] = { c.r, c.g, c.b, c.a };
+			memcpy(ptr, v, sizeof(v));
+		} break;
+		default: {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool StateChannel::write(const godot::Variant **p_arguments, int p_argcount) {
+	std::atomic<uint32_t> *sequence = get_sequence();
+	uint32_t seq = sequence->load(std::memory_order_relaxed);
+	sequence->store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	bool ok = true;
+	if (p_argcount == 1 && p_arguments[0]->get_type() == godot::Variant::DICTIONARY) {
+		godot::Dictionary values = *p_arguments[0];
+		for (size_t i = 0; i < _fields.size(); ++i) {
+			if (values.has(_keys[i])) {
+				ok = write_field(_fields[i], values[_keys[i]]) && ok;
+			}
+		}
+	} else {
+		if ((size_t)p_argcount > _fields.size()) {
+			ok = false;
+		}
+		for (int i = 0; i < p_argcount && (size_t)i < _fields.size(); ++i) {
+			ok = write_field(_fields[i], *p_arguments[i]) && ok;
+		}
+	}
+
+	sequence->store(seq + 2, std::memory_order_release);
+	if (!ok) {
+		LOGE("Invalid values written to state channel: %s", _name.c_str());
+	}
+	return ok;
+}
+
+bool StateChannel::read(uint8_t *r_data) {
+	std::atomic<uint32_t> *sequence = get_sequence();
+	for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+		uint32_t before = sequence->load(std::memory_order_acquire);
+		if (before % 2 != 0) {
+			std::this_thread::yield();
+			continue;
+		}
+		memcpy(r_data + HEADER_SIZE, get_data() + HEADER_SIZE, _size - HEADER_SIZE);
+		// Keeps the copy from being reordered after the second sequence load.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence->load(std::memory_order_relaxed) == before) {
+			memset(r_data, 0, HEADER_SIZE);
+			memcpy(r_data, &before, sizeof(before));
+			return true;
+		}
+	}
+	return false;
+}
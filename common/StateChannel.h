@@ -0,0 +1,127 @@
+/**************************************************************************/
+/*  StateChannel.h                                                        */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <godot_cpp/variant/variant.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Fixed layout state buffer written by Godot and read from JS without a
+// bridge call per read.
+//
+// The buffer starts with a 32 bit sequence number followed by the fields.
+// Writes are guarded as a seqlock: the sequence is odd while a write is in
+// progress, readers copy the fields and retry if the sequence was odd or
+// changed in the meantime. JS cannot order its loads against the writer,
+// so it reads through read(), which copies a consistent snapshot (see
+// readStateChannel in js/StateChannel.ts).
+class StateChannel {
+public:
+	enum FieldType {
+		FIELD_BOOL, // uint32, 0 or 1
+		FIELD_INT32,
+		FIELD_UINT32,
+		FIELD_FLOAT32,
+		FIELD_FLOAT64,
+		FIELD_VECTOR2, // 2 x float32
+		FIELD_VECTOR3, // 3 x float32
+		FIELD_COLOR, // 4 x float32
+		FIELD_MAX,
+	};
+
+	struct Field {
+		std::string name;
+		FieldType type;
+		uint32_t offset;
+	};
+
+	static const uint32_t HEADER_SIZE = 8;
+
+private:
+	static std::mutex _registry_mutex;
+	static std::map<std::string, std::shared_ptr<StateChannel>> _registry;
+
+	std::string _name;
+	std::vector<Field> _fields;
+	std::vector<godot::Variant> _keys;
+	std::unique_ptr<uint64_t[]> _storage;
+	size_t _size = 0;
+
+	StateChannel(const std::string &p_name, const std::vector<std::pair<std::string, FieldType>> &p_layout);
+
+	std::atomic<uint32_t> *get_sequence() {
+		return reinterpret_cast<std::atomic<uint32_t> *>(_storage.get());
+	}
+
+	bool write_field(const Field &p_field, const godot::Variant &p_value);
+
+public:
+	// Returns the channel registered under the name, or creates it. Fails
+	// (returns nullptr) if a channel with the same name but a different layout exists.
+	static std::shared_ptr<StateChannel> get_or_create(const std::string &p_name, const std::vector<std::pair<std::string, FieldType>> &p_layout);
+
+	// Drops the channel from the registry, the memory stays valid while it is referenced.
+	static void release(const std::string &p_name);
+
+	static bool parse_field_type(const std::string &p_type, FieldType &r_type);
+	static const char *get_field_type_name(FieldType p_type);
+
+	const std::string &get_name() const {
+		return _name;
+	}
+
+	const std::vector<Field> &get_fields() const {
+		return _fields;
+	}
+
+	uint8_t *get_data() {
+		return reinterpret_cast<uint8_t *>(_storage.get());
+	}
+
+	size_t get_size() const {
+		return _size;
+	}
+
+	uint32_t get_sequence_value() {
+		return get_sequence()->load(std::memory_order_acquire);
+	}
+
+	// Writes the fields in layout order, or from a single Dictionary keyed by
+	// field name. Must only be called from one thread at a time, normally the
+	// Godot thread.
+	bool write(const godot::Variant **p_arguments, int p_argcount);
+
+	// Copies the last completed write, header included, into r_data of
+	// get_size() bytes. Can be called from any thread. Returns false if the
+	// writer kept overlapping the copy.
+	bool read(uint8_t *r_data);
+};
@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*  StringTransfer.cpp                                                    */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "StringTransfer.h"
+
+#include "TextKernels.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace facebook;
+
+static thread_local std::vector<char32_t> utf32_buffer;
+static thread_local std::vector<char16_t> utf16_buffer;
+static thread_local std::vector<char> ascii_buffer;
+
+static godot::String make_godot_string(const std::vector<char32_t> &p_chars) {
+	godot::String s;
+	if (p_chars.empty()) {
+		return s;
+	}
+	s.resize(p_chars.size() + 1);
+	char32_t *dst = s.ptrw();
+	memcpy(dst, p_chars.data(), p_chars.size() * sizeof(char32_t));
+	dst[p_chars.size()] = 0;
+	return s;
+}
+
+godot::String StringTransfer::to_godot(jsi::Runtime &rt, const jsi::String &p_string) {
+	utf32_buffer.clear();
+	TextKernels::Utf32Collector collector{ utf32_buffer };
+	p_string.getStringData(rt, collector);
+	collector.finish();
+	godot::String s = make_godot_string(utf32_buffer);
+	TextKernels::trim_buffer(utf32_buffer);
+	return s;
+}
+
+godot::StringName StringTransfer::to_godot_name(jsi::Runtime &rt, const jsi::PropNameID &p_name) {
+	utf32_buffer.clear();
+	TextKernels::Utf32Collector collector{ utf32_buffer };
+	p_name.getPropNameIdData(rt, collector);
+	collector.finish();
+	godot::StringName name(make_godot_string(utf32_buffer));
+	TextKernels::trim_buffer(utf32_buffer);
+	return name;
+}
+
+jsi::String StringTransfer::to_jsi(jsi::Runtime &rt, const godot::String &p_string) {
+	const char32_t *src = p_string.ptr();
+	size_t len = (size_t)p_string.length();
+	if (len == 0) {
+		return jsi::String::createFromAscii(rt, "", 0);
+	}
+	uint32_t max = TextKernels::max_char(src, len);
+	if (max < 0x80) {
+		ascii_buffer.resize(len);
+		TextKernels::narrow_ascii(src, ascii_buffer.data(), len);
+		jsi::String s = jsi::String::createFromAscii(rt, ascii_buffer.data(), len);
+		TextKernels::trim_buffer(ascii_buffer);
+		return s;
+	}
+	if (max < 0x10000) {
+		utf16_buffer.resize(len);
+		TextKernels::narrow_bmp(src, utf16_buffer.data(), len);
+	} else {
+		TextKernels::utf32_to_utf16(src, len, utf16_buffer);
+	}
+	jsi::String s = jsi::String::createFromUtf16(rt, utf16_buffer.data(), utf16_buffer.size());
+	TextKernels::trim_buffer(utf16_buffer);
+	return s;
+}
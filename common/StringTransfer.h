@@ -0,0 +1,42 @@
+/**************************************************************************/
+/*  StringTransfer.h                                                      */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+#include <jsi/jsi.h>
+
+// String conversion between JSI and Godot without going through UTF-8.
+// JS strings are read as ASCII or UTF-16 chunks and widened directly to
+// Godot's UTF-32, Godot strings are narrowed to ASCII when possible and
+// encoded to UTF-16 otherwise.
+class StringTransfer {
+public:
+	static godot::String to_godot(facebook::jsi::Runtime &rt, const facebook::jsi::String &p_string);
+	static godot::StringName to_godot_name(facebook::jsi::Runtime &rt, const facebook::jsi::PropNameID &p_name);
+
+	static facebook::jsi::String to_jsi(facebook::jsi::Runtime &rt, const godot::String &p_string);
+};
@@ -0,0 +1,105 @@
+/**************************************************************************/
+/*  SyncCall.cpp                                                          */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "SyncCall.h"
+
+SyncWaiter *SyncWaiter::get_current() {
+	// Allocated once per thread and intentionally leaked, see SyncWaiter.
+	static thread_local SyncWaiter *waiter = new SyncWaiter();
+	return waiter;
+}
+
+bool SyncWaiter::post(SyncCall *p_call) {
+	{
+		std::lock_guard lock(_inbox_mutex);
+		if (_wait_depth == 0) {
+			return false;
+		}
+		p_call->_next = nullptr;
+		if (_inbox_last) {
+			_inbox_last->_next = p_call;
+		} else {
+			_inbox_first = p_call;
+		}
+		_inbox_last = p_call;
+	}
+	notify();
+	return true;
+}
+
+bool SyncWaiter::run_inbox() {
+	bool ran = false;
+	while (true) {
+		SyncCall *call = nullptr;
+		{
+			std::lock_guard lock(_inbox_mutex);
+			call = _inbox_first;
+			if (!call) {
+				break;
+			}
+			_inbox_first = call->_next;
+			if (!_inbox_first) {
+				_inbox_last = nullptr;
+			}
+		}
+		call->run();
+		ran = true;
+	}
+	return ran;
+}
+
+void SyncWaiter::wait_until(const SyncCompletion &p_completion) {
+	{
+		std::lock_guard lock(_inbox_mutex);
+		_wait_depth++;
+	}
+	while (true) {
+		uint32_t signal = prepare();
+		if (p_completion.is_done()) {
+			break;
+		}
+		if (run_inbox()) {
+			continue;
+		}
+		DrainFunc drain = _drain.load(std::memory_order_acquire);
+		void *userdata = _drain_userdata.load(std::memory_order_acquire);
+		if (drain && userdata && drain(userdata)) {
+			continue;
+		}
+		wait(signal);
+	}
+	while (true) {
+		{
+			// Calls posted while the wait was ending must still run, their
+			// callers rely on it.
+			std::lock_guard lock(_inbox_mutex);
+			if (!_inbox_first) {
+				_wait_depth--;
+				return;
+			}
+		}
+		run_inbox();
+	}
+}
@@ -0,0 +1,180 @@
+/**************************************************************************/
+/*  SyncCall.h                                                            */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+
+// Non-owning reference to a callable, it never allocates. The callable has
+// to outlive the SyncFunction, which holds for a caller that waits for the call.
+class SyncFunction {
+	void *_callable;
+	void (*_invoke)(void *);
+
+public:
+	template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SyncFunction>>>
+	SyncFunction(F &f) :
+			_callable((void *)&f), _invoke([](void *callable) { (*static_cast<F *>(callable))(); }) {}
+
+	void operator()() const {
+		_invoke(_callable);
+	}
+};
+
+class SyncCall;
+class SyncCompletion;
+
+// Wakes a thread that waits for a synchronous call.
+// There is one per thread, it is never freed, so a completing thread can
+// still notify it after the waiting call already returned.
+//
+// Waiting is reentrant: while a thread waits, it keeps running the calls
+// posted to its inbox and the tasks of the executor bound to it, so two
+// threads that synchronously call into each other do not deadlock.
+class SyncWaiter {
+public:
+	// Runs queued work of the thread, returns false if there was nothing to run.
+	typedef bool (*DrainFunc)(void *p_userdata);
+
+private:
+	std::atomic<uint32_t> _signal = 0;
+	std::atomic<DrainFunc> _drain = nullptr;
+	std::atomic<void *> _drain_userdata = nullptr;
+
+	std::mutex _inbox_mutex;
+	SyncCall *_inbox_first = nullptr;
+	SyncCall *_inbox_last = nullptr;
+	int _wait_depth = 0;
+
+	bool run_inbox();
+
+public:
+	static SyncWaiter *get_current();
+
+	// Read the signal before checking the wait condition, then pass it to wait().
+	uint32_t prepare() const {
+		return _signal.load(std::memory_order_acquire);
+	}
+
+	// Returns when notify() was called since prepare() returned signal.
+	void wait(uint32_t signal) const {
+		_signal.wait(signal, std::memory_order_acquire);
+	}
+
+	void notify() {
+		_signal.fetch_add(1, std::memory_order_release);
+		_signal.notify_all();
+	}
+
+	// Lets waits on this thread run the tasks of an executor, which has to
+	// notify() this waiter whenever it queues something.
+	void set_drain(DrainFunc p_drain, void *p_userdata) {
+		_drain_userdata.store(p_userdata, std::memory_order_relaxed);
+		_drain.store(p_drain, std::memory_order_release);
+	}
+
+	// Removes the drain if it was set for p_userdata, called when the
+	// executor goes away while the thread keeps running.
+	void clear_drain(void *p_userdata) {
+		void *expected = p_userdata;
+		if (_drain_userdata.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+			_drain.store(nullptr, std::memory_order_release);
+		}
+	}
+
+	// Queues a call for the thread if it is currently waiting, and returns
+	// false otherwise. A queued call is run before the wait returns.
+	bool post(SyncCall *p_call);
+
+	// Blocks the calling thread until the completion is done, running queued work meanwhile.
+	void wait_until(const SyncCompletion &p_completion);
+};
+
+// Completion flag of one synchronous call, created on the waiting thread's stack.
+class SyncCompletion {
+	SyncWaiter *_waiter;
+	std::atomic<bool> _done = false;
+
+public:
+	SyncCompletion() :
+			_waiter(SyncWaiter::get_current()) {}
+
+	SyncWaiter *get_waiter() const {
+		return _waiter;
+	}
+
+	bool is_done() const {
+		return _done.load(std::memory_order_acquire);
+	}
+
+	// Called by the thread that ran the call. The completion must not be
+	// touched after this, the waiting thread may already have returned.
+	void complete() {
+		SyncWaiter *waiter = _waiter;
+		_done.store(true, std::memory_order_release);
+		waiter->notify();
+	}
+
+	// Blocks the calling thread until complete() was called.
+	void wait() const {
+		_waiter->wait_until(*this);
+	}
+};
+
+// A callable and its completion, queued in a SyncWaiter inbox.
+class SyncCall {
+	friend class SyncWaiter;
+
+	SyncFunction _func;
+	SyncCompletion _completion;
+	std::exception_ptr _error;
+	SyncCall *_next = nullptr;
+
+public:
+	SyncCall(SyncFunction p_func) :
+			_func(p_func) {}
+
+	void run() {
+		// The caller is blocked until complete(), whatever the call does.
+		try {
+			_func();
+		} catch (...) {
+			_error = std::current_exception();
+		}
+		_completion.complete();
+	}
+
+	// Rethrows what the call threw.
+	void wait() const {
+		_completion.wait();
+		if (_error) {
+			std::rethrow_exception(_error);
+		}
+	}
+};
@@ -0,0 +1,526 @@
+/**************************************************************************/
+/*  TaskExecutor.cpp                                                      */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "TaskExecutor.h"
+#define LOG_TAG "TaskExecutor"
+#include "godot-log.h"
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+void TaskExecutor::bind_current_thread() {
+	_thread_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
+	SyncWaiter *waiter = SyncWaiter::get_current();
+	waiter->set_drain(&TaskExecutor::drain_nested, this);
+	_waiter.store(waiter, std::memory_order_release);
+}
+
+void TaskExecutor::unbind_thread() {
+	// The waiter of the thread is never freed, only the drain pointing back
+	// at this executor has to go.
+	SyncWaiter *waiter = _waiter.exchange(nullptr, std::memory_order_acq_rel);
+	if (waiter) {
+		waiter->clear_drain(this);
+	}
+}
+
+TaskExecutor::~TaskExecutor() {
+	unbind_thread();
+}
+
+void TaskExecutor::notify_waiter() {
+	// Wakes the executor thread if it is blocked in a synchronous call.
+	SyncWaiter *waiter = _waiter.load(std::memory_order_acquire);
+	if (waiter) {
+		waiter->notify();
+	}
+}
+
+bool TaskExecutor::request_wake() {
+	// Called with _mutex held.
+	if (_wake_pending) {
+		return false;
+	}
+	_wake_pending = true;
+	return true;
+}
+
+void TaskExecutor::push(std::function<void()> &&f, TaskPriority priority) {
+	bool needs_wake = false;
+	{
+		std::lock_guard lock(_mutex);
+		if (_shut_down) {
+			return;
+		}
+		_lanes[priority].push_back(Task{ std::move(f), nullptr, Clock::now() });
+		needs_wake = request_wake();
+	}
+	notify_waiter();
+	if (needs_wake) {
+		wake();
+	}
+}
+
+bool TaskExecutor::push_sync(SyncTask *task, TaskPriority priority) {
+	bool needs_wake = false;
+	{
+		std::lock_guard lock(_mutex);
+		if (_shut_down) {
+			return false;
+		}
+		task->enqueued = Clock::now();
+		SyncQueue &queue = _sync_lanes[priority];
+		if (queue.last) {
+			queue.last->next = task;
+		} else {
+			queue.first = task;
+		}
+		queue.last = task;
+		queue.size++;
+		needs_wake = request_wake();
+	}
+	notify_waiter();
+	if (needs_wake) {
+		wake();
+	}
+	return true;
+}
+
+size_t TaskExecutor::lane_size(TaskPriority priority) const {
+	// Called with _mutex held.
+	return _lanes[priority].size() + _sync_lanes[priority].size;
+}
+
+bool TaskExecutor::pop(TaskPriority priority, Task &r_task) {
+	// Called with _mutex held.
+	// Synchronous callers are blocked, so they go before the queued tasks of the lane.
+	SyncQueue &queue = _sync_lanes[priority];
+	std::deque<Task> &lane = _lanes[priority];
+	Clock::time_point enqueued;
+	if (queue.first) {
+		SyncTask *task = queue.first;
+		queue.first = task->next;
+		if (!queue.first) {
+			queue.last = nullptr;
+		}
+		queue.size--;
+		r_task.sync = task;
+		enqueued = task->enqueued;
+	} else if (!lane.empty()) {
+		r_task = std::move(lane.front());
+		lane.pop_front();
+		enqueued = r_task.enqueued;
+	} else {
+		return false;
+	}
+
+	uint64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - enqueued).count();
+	TaskStats &stats = _stats[priority];
+	stats.count++;
+	stats.total_latency_ns += latency;
+	stats.last_latency_ns = latency;
+	_last_latency_ns = latency;
+	if (latency > stats.max_latency_ns) {
+		stats.max_latency_ns = latency;
+	}
+	return true;
+}
+
+void TaskExecutor::run_task(Task &task) {
+	if (task.sync) {
+		// The caller is blocked until complete(), whatever func does.
+		try {
+			task.sync->func();
+		} catch (...) {
+			task.sync->error = std::current_exception();
+		}
+		task.sync->completion.complete();
+	} else {
+		task.func();
+	}
+}
+
+bool TaskExecutor::can_start_background(Clock::time_point now, bool idle, size_t ran) {
+	// Called with _mutex held.
+	if (!_frames_active) {
+		return true;
+	}
+	if (now > _deadline + (_deadline - _frame_start)) {
+		// A whole frame was missed, the frame loop is stalled, don't wait for it.
+		return true;
+	}
+	if (idle && ran == 0) {
+		// Make progress every frame, even when the frames are over budget.
+		return true;
+	}
+	return now + std::chrono::microseconds(_config.frame_reserve_us) < _deadline;
+}
+
+size_t TaskExecutor::run_background(bool idle) {
+	size_t ran = 0;
+	while (true) {
+		Task task;
+		{
+			std::lock_guard lock(_mutex);
+			if (lane_size(TASK_PRIORITY_BACKGROUND) == 0) {
+				break;
+			}
+			if (lane_size(TASK_PRIORITY_URGENT) > 0 || lane_size(TASK_PRIORITY_FRAME) > 0) {
+				// Higher priority work arrived, it already woke the thread again.
+				break;
+			}
+			if (!can_start_background(Clock::now(), idle, ran)) {
+				_stats[TASK_PRIORITY_BACKGROUND].deferred++;
+				break;
+			}
+			pop(TASK_PRIORITY_BACKGROUND, task);
+		}
+		run_task(task);
+		ran++;
+	}
+	return ran;
+}
+
+size_t TaskExecutor::run_lanes(size_t budget) {
+	size_t ran = 0;
+	while (ran < budget) {
+		Task task;
+		{
+			std::lock_guard lock(_mutex);
+			if (!pop(TASK_PRIORITY_URGENT, task) && !pop(TASK_PRIORITY_FRAME, task)) {
+				break;
+			}
+		}
+		run_task(task);
+		ran++;
+	}
+	return ran;
+}
+
+bool TaskExecutor::drain_nested(void *p_userdata) {
+	// Runs while the executor thread waits for a synchronous call, e.g. when
+	// Godot waits for JS which calls back into Godot. Background tasks stay queued.
+	TaskExecutor *self = static_cast<TaskExecutor *>(p_userdata);
+	size_t budget = 0;
+	{
+		std::lock_guard lock(self->_mutex);
+		budget = self->lane_size(TASK_PRIORITY_URGENT) + self->lane_size(TASK_PRIORITY_FRAME);
+	}
+	return self->run_lanes(budget) > 0;
+}
+
+size_t TaskExecutor::run_pending() {
+	size_t budget = 0;
+	{
+		std::lock_guard lock(_mutex);
+		_wake_pending = false;
+		budget = lane_size(TASK_PRIORITY_URGENT) + lane_size(TASK_PRIORITY_FRAME);
+	}
+	// Tasks queued while running will wake the thread again, so only run what
+	// was there on entry, but always pick the most urgent one first.
+	size_t ran = run_lanes(budget);
+	return ran + run_background(false);
+}
+
+size_t TaskExecutor::run_idle() {
+	return run_background(true);
+}
+
+void TaskExecutor::begin_frame(Clock::time_point deadline) {
+	std::lock_guard lock(_mutex);
+	_frames_active = true;
+	_frame_start = Clock::now();
+	_deadline = deadline;
+}
+
+void TaskExecutor::end_frames() {
+	bool needs_wake = false;
+	{
+		std::lock_guard lock(_mutex);
+		_frames_active = false;
+		if (lane_size(TASK_PRIORITY_BACKGROUND) > 0) {
+			needs_wake = request_wake();
+		}
+	}
+	if (needs_wake) {
+		wake();
+	}
+}
+
+void TaskExecutor::enqueue(std::function<void()> f, TaskPriority priority) {
+	if (is_current_thread()) {
+		f();
+		return;
+	}
+	push(std::move(f), priority);
+}
+
+void TaskExecutor::post(std::function<void()> f, TaskPriority priority) {
+	push(std::move(f), priority);
+}
+
+void TaskExecutor::run_sync(SyncFunction f, TaskPriority priority) {
+	if (is_current_thread()) {
+		f();
+		return;
+	}
+	SyncTask task(f);
+	if (!push_sync(&task, priority)) {
+		throw std::runtime_error("The executor thread has shut down");
+	}
+	task.completion.wait();
+
+	uint64_t roundTrip = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - task.enqueued).count();
+	{
+		std::lock_guard lock(_mutex);
+		_sync_stats.count++;
+		_sync_stats.total_latency_ns += roundTrip;
+		_sync_stats.last_latency_ns = roundTrip;
+		if (roundTrip > _sync_stats.max_latency_ns) {
+			_sync_stats.max_latency_ns = roundTrip;
+		}
+	}
+	if (task.error) {
+		std::rethrow_exception(task.error);
+	}
+}
+
+void TaskExecutor::shut_down() {
+	std::deque<Task> dropped;
+	SyncTask *waiting = nullptr;
+	{
+		std::lock_guard lock(_mutex);
+		_shut_down = true;
+		for (int i = 0; i < TASK_PRIORITY_MAX; i++) {
+			while (!_lanes[i].empty()) {
+				dropped.push_back(std::move(_lanes[i].front()));
+				_lanes[i].pop_front();
+			}
+			SyncQueue &queue = _sync_lanes[i];
+			while (queue.first) {
+				SyncTask *task = queue.first;
+				queue.first = task->next;
+				task->next = waiting;
+				waiting = task;
+			}
+			queue.last = nullptr;
+			queue.size = 0;
+		}
+	}
+	unbind_thread();
+	if (!dropped.empty()) {
+		LOGW("Dropping %zu queued tasks on shutdown", dropped.size());
+	}
+	while (waiting) {
+		SyncTask *task = waiting;
+		waiting = task->next;
+		task->error = std::make_exception_ptr(std::runtime_error("The executor thread has shut down"));
+		task->completion.complete();
+	}
+}
+
+void TaskExecutor::configure(const ThreadConfig &config) {
+	{
+		std::lock_guard lock(_mutex);
+		_config = config;
+	}
+	std::function<void()> applyFunc = [config]() {
+		apply_thread_config(config);
+	};
+	enqueue(applyFunc, TASK_PRIORITY_URGENT);
+}
+
+ThreadConfig TaskExecutor::get_config() {
+	std::lock_guard lock(_mutex);
+	return _config;
+}
+
+TaskStats TaskExecutor::get_stats() {
+	std::lock_guard lock(_mutex);
+	TaskStats total;
+	for (int i = 0; i < TASK_PRIORITY_MAX; ++i) {
+		const TaskStats &stats = _stats[i];
+		total.count += stats.count;
+		total.total_latency_ns += stats.total_latency_ns;
+		total.deferred += stats.deferred;
+		if (stats.max_latency_ns > total.max_latency_ns) {
+			total.max_latency_ns = stats.max_latency_ns;
+		}
+	}
+	total.last_latency_ns = _last_latency_ns;
+	return total;
+}
+
+TaskStats TaskExecutor::get_stats(TaskPriority priority) {
+	std::lock_guard lock(_mutex);
+	return _stats[priority];
+}
+
+TaskStats TaskExecutor::get_sync_stats() {
+	std::lock_guard lock(_mutex);
+	return _sync_stats;
+}
+
+#if defined(__linux__)
+static std::vector<int> get_big_cores() {
+	std::vector<int> cores;
+	long cpuCount = sysconf(_SC_NPROCESSORS_CONF);
+	long bestFreq = 0;
+	bool heterogeneous = false;
+	for (int cpu = 0; cpu < cpuCount; ++cpu) {
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+		FILE *f = fopen(path, "r");
+		if (!f) {
+			continue;
+		}
+		long freq = 0;
+		if (fscanf(f, "%ld", &freq) != 1) {
+			freq = 0;
+		}
+		fclose(f);
+		if (freq <= 0) {
+			continue;
+		}
+		if (!cores.empty() && freq != bestFreq) {
+			heterogeneous = true;
+		}
+		if (freq > bestFreq) {
+			bestFreq = freq;
+			cores.clear();
+		}
+		if (freq == bestFreq) {
+			cores.push_back(cpu);
+		}
+	}
+	if (!heterogeneous) {
+		// All cores are the same, pinning would only restrict the scheduler.
+		cores.clear();
+	}
+	return cores;
+}
+#endif
+
+bool TaskExecutor::apply_thread_config(const ThreadConfig &config) {
+	bool ok = true;
+#if defined(__APPLE__)
+	if (config.priority != ThreadConfig::PRIORITY_DEFAULT) {
+		int res = pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+		if (res != 0) {
+			LOGE("Unable to set thread QoS class: %d", res);
+			ok = false;
+		}
+	}
+	if (config.prefer_big_cores) {
+		LOGW("CPU affinity is not supported on this platform");
+	}
+#elif defined(__linux__)
+	pid_t tid = (pid_t)syscall(SYS_gettid);
+	bool priorityApplied = config.priority == ThreadConfig::PRIORITY_DEFAULT;
+	if (config.priority == ThreadConfig::PRIORITY_REALTIME) {
+		sched_param param = {};
+		param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+		int res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+		if (res == 0) {
+			priorityApplied = true;
+		} else {
+			LOGW("SCHED_FIFO not permitted (%d), falling back to nice value", res);
+		}
+	}
+	if (!priorityApplied) {
+		if (setpriority(PRIO_PROCESS, tid, -8) != 0) {
+			LOGE("Unable to set thread nice value: %d", errno);
+			ok = false;
+		}
+	}
+	if (config.prefer_big_cores) {
+		std::vector<int> cores = get_big_cores();
+		if (!cores.empty()) {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			for (int cpu : cores) {
+				CPU_SET(cpu, &set);
+			}
+			if (sched_setaffinity(tid, sizeof(set), &set) != 0) {
+				LOGE("Unable to set thread affinity: %d", errno);
+				ok = false;
+			}
+		}
+	}
+#endif
+	return ok;
+}
+
+StdThreadExecutor::StdThreadExecutor() {
+	_thread = std::thread(&StdThreadExecutor::run, this);
+}
+
+StdThreadExecutor::~StdThreadExecutor() {
+	{
+		std::lock_guard lock(_wait_mutex);
+		_quit = true;
+	}
+	_wait_var.notify_one();
+	_thread.join();
+}
+
+void StdThreadExecutor::wake() {
+	{
+		std::lock_guard lock(_wait_mutex);
+		_woken = true;
+	}
+	_wait_var.notify_one();
+}
+
+void StdThreadExecutor::run() {
+	bind_current_thread();
+	while (true) {
+		{
+			std::unique_lock lock(_wait_mutex);
+			_wait_var.wait(lock, [this]() { return _woken || _quit; });
+			if (_quit) {
+				break;
+			}
+			_woken = false;
+		}
+		run_pending();
+	}
+	// Run what was queued before the executor was destroyed, then fail late callers.
+	run_pending();
+	shut_down();
+}
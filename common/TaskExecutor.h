@@ -0,0 +1,216 @@
+/**************************************************************************/
+/*  TaskExecutor.h                                                        */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "SyncCall.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct ThreadConfig {
+	enum Priority {
+		PRIORITY_DEFAULT, // Keep what the platform thread was created with.
+		PRIORITY_HIGH, // nice -8 (Android / Linux), QoS user interactive (iOS).
+		PRIORITY_REALTIME, // SCHED_FIFO where permitted, falls back to PRIORITY_HIGH.
+	};
+
+	Priority priority = PRIORITY_DEFAULT;
+	// Pin the thread to the cores with the highest maximum frequency (Android / Linux only).
+	bool prefer_big_cores = false;
+	// Time kept free before the vsync deadline, background tasks are not started inside it.
+	uint32_t frame_reserve_us = 4000;
+};
+
+enum TaskPriority {
+	TASK_PRIORITY_URGENT, // Input, surface and focus changes.
+	TASK_PRIORITY_FRAME, // Work the next frame depends on, e.g. JS worklets.
+	TASK_PRIORITY_BACKGROUND, // Deferred to the idle time of the frame when the deadline is near.
+	TASK_PRIORITY_MAX,
+};
+
+struct TaskStats {
+	uint64_t count = 0;
+	uint64_t total_latency_ns = 0;
+	uint64_t max_latency_ns = 0;
+	uint64_t last_latency_ns = 0;
+	uint64_t deferred = 0;
+};
+
+// Task queue of a thread that runs Godot work.
+// The queue, the synchronous call and the statistics are shared by all
+// platforms, a platform only provides the thread itself and wake(), which
+// has to make the thread call run_pending() soon.
+//
+// Tasks are kept in one lane per TaskPriority. Urgent and frame tasks always
+// run when the thread wakes up, urgent ones first. When the platform reports
+// its frames with begin_frame(), background tasks only start if there is
+// enough time left before the vsync deadline, otherwise they wait for
+// run_idle() after the next iteration.
+class TaskExecutor {
+	typedef std::chrono::steady_clock Clock;
+
+	// Queued by run_sync(), lives on the stack of the waiting caller.
+	struct SyncTask {
+		SyncFunction func;
+		SyncCompletion completion;
+		Clock::time_point enqueued;
+		// Thrown by func, or set when the executor shut down first. Rethrown to the caller.
+		std::exception_ptr error;
+		SyncTask *next = nullptr;
+
+		SyncTask(SyncFunction p_func) :
+				func(p_func) {}
+	};
+
+	struct Task {
+		std::function<void()> func;
+		SyncTask *sync = nullptr;
+		Clock::time_point enqueued;
+	};
+
+	// Synchronous calls are kept in an intrusive list, queueing them does not allocate.
+	struct SyncQueue {
+		SyncTask *first = nullptr;
+		SyncTask *last = nullptr;
+		size_t size = 0;
+	};
+
+	std::mutex _mutex;
+	std::deque<Task> _lanes[TASK_PRIORITY_MAX];
+	SyncQueue _sync_lanes[TASK_PRIORITY_MAX];
+	bool _wake_pending = false;
+	bool _shut_down = false;
+	std::atomic<std::thread::id> _thread_id;
+	std::atomic<SyncWaiter *> _waiter = nullptr;
+	ThreadConfig _config;
+	TaskStats _stats[TASK_PRIORITY_MAX];
+	TaskStats _sync_stats;
+	uint64_t _last_latency_ns = 0;
+	bool _frames_active = false;
+	Clock::time_point _frame_start;
+	Clock::time_point _deadline;
+
+	void unbind_thread();
+	void push(std::function<void()> &&f, TaskPriority priority);
+	bool push_sync(SyncTask *task, TaskPriority priority);
+	bool request_wake();
+	void notify_waiter();
+	size_t lane_size(TaskPriority priority) const;
+	bool pop(TaskPriority priority, Task &r_task);
+	static void run_task(Task &task);
+	size_t run_lanes(size_t budget);
+	static bool drain_nested(void *p_userdata);
+	bool can_start_background(Clock::time_point now, bool idle, size_t ran);
+	size_t run_background(bool idle);
+
+protected:
+	virtual void wake() = 0;
+
+	// Stops taking tasks, called when the executor thread exits. Queued tasks
+	// are dropped, and synchronous callers that still wait, or call later,
+	// get an exception instead of blocking forever. The thread is unbound.
+	void shut_down();
+
+public:
+	virtual ~TaskExecutor();
+
+	// Has to be called on the executor thread before it starts running tasks.
+	// Synchronous waits on that thread run the tasks of the executor until it
+	// is shut down or destroyed.
+	void bind_current_thread();
+
+	bool is_current_thread() const {
+		return _thread_id.load(std::memory_order_relaxed) == std::this_thread::get_id();
+	}
+
+	// Runs the tasks queued so far. Has to be called on the executor thread.
+	size_t run_pending();
+
+	// Runs deferred background tasks in the remaining time of the frame,
+	// at least one per call. Has to be called on the executor thread after
+	// the frame was rendered.
+	size_t run_idle();
+
+	// Reports the start of a frame and the vsync deadline of the next one.
+	void begin_frame(Clock::time_point deadline);
+
+	// Reports that no more frames are coming (e.g. paused), background tasks are no longer deferred.
+	void end_frames();
+
+	// Runs f immediately when called on the executor thread, queues it otherwise.
+	void enqueue(std::function<void()> f, TaskPriority priority = TASK_PRIORITY_FRAME);
+
+	// Always queues f, even when called on the executor thread.
+	void post(std::function<void()> f, TaskPriority priority = TASK_PRIORITY_FRAME);
+
+	// Runs f on the executor thread and waits until it finished.
+	// f is not copied and the call does not allocate. While waiting, the
+	// calling thread keeps running the work queued for it (see SyncWaiter).
+	// Exceptions thrown by f are rethrown to the caller.
+	void run_sync(SyncFunction f, TaskPriority priority = TASK_PRIORITY_URGENT);
+
+	// Applies the scheduling configuration on the executor thread.
+	void configure(const ThreadConfig &config);
+
+	ThreadConfig get_config();
+
+	// Statistics of all lanes combined.
+	TaskStats get_stats();
+
+	TaskStats get_stats(TaskPriority priority);
+
+	// Round trip times of run_sync() calls from other threads, from queueing to waking up the caller.
+	TaskStats get_sync_stats();
+
+	// Applies the scheduling configuration to the calling thread.
+	static bool apply_thread_config(const ThreadConfig &config);
+};
+
+// Portable implementation on top of std::thread, used where there is no
+// platform run loop to integrate with (e.g. host builds on Linux).
+class StdThreadExecutor : public TaskExecutor {
+	std::mutex _wait_mutex;
+	std::condition_variable _wait_var;
+	bool _woken = false;
+	bool _quit = false;
+	std::thread _thread;
+
+	void run();
+
+protected:
+	void wake() override;
+
+public:
+	StdThreadExecutor();
+	~StdThreadExecutor();
+};
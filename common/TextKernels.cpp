@@ -0,0 +1,125 @@
+/**************************************************************************/
+/*  TextKernels.cpp                                                       */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "TextKernels.h"
+
+uint32_t TextKernels::max_char(const char32_t *p_src, size_t p_len) {
+	uint32_t acc = 0;
+	for (size_t i = 0; i < p_len; i++) {
+		acc |= (uint32_t)p_src[i];
+	}
+	return acc;
+}
+
+void TextKernels::widen_ascii(const uint8_t *__restrict p_src, char32_t *__restrict r_dst, size_t p_len) {
+	for (size_t i = 0; i < p_len; i++) {
+		r_dst[i] = p_src[i];
+	}
+}
+
+void TextKernels::narrow_ascii(const char32_t *__restrict p_src, char *__restrict r_dst, size_t p_len) {
+	for (size_t i = 0; i < p_len; i++) {
+		r_dst[i] = (char)p_src[i];
+	}
+}
+
+void TextKernels::narrow_bmp(const char32_t *__restrict p_src, char16_t *__restrict r_dst, size_t p_len) {
+	for (size_t i = 0; i < p_len; i++) {
+		r_dst[i] = (char16_t)p_src[i];
+	}
+}
+
+bool TextKernels::has_surrogates(const char16_t *p_src, size_t p_len) {
+	bool found = false;
+	for (size_t i = 0; i < p_len; i++) {
+		found |= (p_src[i] & 0xf800) == 0xd800;
+	}
+	return found;
+}
+
+void TextKernels::utf32_to_utf16(const char32_t *p_src, size_t p_len, std::vector<char16_t> &r_dst) {
+	r_dst.clear();
+	r_dst.reserve(p_len * 2);
+	for (size_t i = 0; i < p_len; i++) {
+		uint32_t c = p_src[i];
+		if (c >= 0x10000 && c <= 0x10ffff) {
+			c -= 0x10000;
+			r_dst.push_back((char16_t)(0xd800 + (c >> 10)));
+			r_dst.push_back((char16_t)(0xdc00 + (c & 0x3ff)));
+		} else if (c < 0x10000) {
+			r_dst.push_back((char16_t)c);
+		} else {
+			r_dst.push_back(0xfffd);
+		}
+	}
+}
+
+void TextKernels::Utf32Collector::append_ascii(const uint8_t *p_src, size_t p_len) {
+	finish();
+	size_t start = out.size();
+	out.resize(start + p_len);
+	widen_ascii(p_src, out.data() + start, p_len);
+}
+
+void TextKernels::Utf32Collector::append_utf16(const char16_t *p_src, size_t p_len) {
+	size_t i = 0;
+	if (high && p_len > 0 && (p_src[0] & 0xfc00) == 0xdc00) {
+		out.push_back(0x10000 + (((char32_t)high - 0xd800) << 10) + (p_src[0] - 0xdc00));
+		high = 0;
+		i = 1;
+	}
+	finish();
+	if (!has_surrogates(p_src + i, p_len - i)) {
+		size_t start = out.size();
+		out.resize(start + p_len - i);
+		char32_t *dst = out.data() + start;
+		for (size_t j = i; j < p_len; j++) {
+			dst[j - i] = p_src[j];
+		}
+		return;
+	}
+	for (; i < p_len; i++) {
+		char16_t c = p_src[i];
+		if ((c & 0xfc00) == 0xd800) {
+			if (i + 1 == p_len) {
+				high = c;
+			} else if ((p_src[i + 1] & 0xfc00) == 0xdc00) {
+				out.push_back(0x10000 + (((char32_t)c - 0xd800) << 10) + (p_src[i + 1] - 0xdc00));
+				i++;
+			} else {
+				out.push_back(c);
+			}
+		} else {
+			out.push_back(c);
+		}
+	}
+}
+
+void TextKernels::Utf32Collector::finish() {
+	if (high) {
+		out.push_back(high);
+		high = 0;
+	}
+}
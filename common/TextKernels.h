@@ -0,0 +1,85 @@
+/**************************************************************************/
+/*  TextKernels.h                                                         */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Conversions between the string encodings of JSI (ASCII / UTF-16) and
+// Godot (UTF-32), used by StringTransfer. The loops are kept simple so the
+// compiler can vectorize them.
+class TextKernels {
+public:
+	// Conversion buffers above this size are freed after use, smaller ones
+	// are kept for the next string.
+	static const size_t MAX_KEPT_BUFFER_BYTES = 64 * 1024;
+
+	// Frees r_buffer if a large string grew it beyond MAX_KEPT_BUFFER_BYTES,
+	// so a thread does not hold on to the largest string it ever converted.
+	template <typename T>
+	static void trim_buffer(std::vector<T> &r_buffer) {
+		if (r_buffer.capacity() * sizeof(T) > MAX_KEPT_BUFFER_BYTES) {
+			std::vector<T>().swap(r_buffer);
+		}
+	}
+
+	// Bitwise or of all characters, to pick the narrowest encoding.
+	static uint32_t max_char(const char32_t *p_src, size_t p_len);
+
+	static void widen_ascii(const uint8_t *__restrict p_src, char32_t *__restrict r_dst, size_t p_len);
+	static void narrow_ascii(const char32_t *__restrict p_src, char *__restrict r_dst, size_t p_len);
+
+	// Characters have to be below 0x10000.
+	static void narrow_bmp(const char32_t *__restrict p_src, char16_t *__restrict r_dst, size_t p_len);
+
+	static bool has_surrogates(const char16_t *p_src, size_t p_len);
+
+	// Encodes p_src to r_dst, characters outside of Unicode become U+FFFD.
+	static void utf32_to_utf16(const char32_t *p_src, size_t p_len, std::vector<char16_t> &r_dst);
+
+	// Appends chunks of ASCII and UTF-16 to a UTF-32 buffer, the way JSI
+	// hands out string data. A surrogate pair can be split between two
+	// chunks, call finish() after the last one. Unpaired surrogates are kept
+	// as they are, like in Godot.
+	struct Utf32Collector {
+		std::vector<char32_t> &out;
+		char16_t high = 0;
+
+		void append_ascii(const uint8_t *p_src, size_t p_len);
+		void append_utf16(const char16_t *p_src, size_t p_len);
+		void finish();
+
+		// Callback signature of getStringData() / getPropNameIdData().
+		void operator()(bool p_ascii, const void *p_data, size_t p_num) {
+			if (p_ascii) {
+				append_ascii((const uint8_t *)p_data, p_num);
+			} else {
+				append_utf16((const char16_t *)p_data, p_num);
+			}
+		}
+	};
+};
@@ -0,0 +1,775 @@
+/**************************************************************************/
+/*  VariantCodec.cpp                                                      */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "VariantCodec.h"
+
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/basis.hpp>
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/node_path.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_float64_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/packed_vector4_array.hpp>
+#include <godot_cpp/variant/plane.hpp>
+#include <godot_cpp/variant/projection.hpp>
+#include <godot_cpp/variant/quaternion.hpp>
+#include <godot_cpp/variant/rect2.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/rid.hpp>
+#include <godot_cpp/variant/signal.hpp>
+#include <godot_cpp/variant/transform2d.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+#include <godot_cpp/variant/vector2.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include <godot_cpp/variant/vector4.hpp>
+#include <godot_cpp/variant/vector4i.hpp>
+
+#include <climits>
+#include <cstring>
+
+// Header flags, see core/io/marshalls.cpp in Godot.
+static const uint32_t ENCODE_MASK = 0xFF;
+static const uint32_t ENCODE_FLAG_64 = 1 << 16;
+static const uint32_t ENCODE_FLAG_OBJECT_AS_ID = 1 << 16;
+// Arrays keep their element type in bits 16-17, dictionaries their key type
+// in bits 16-17 and their value type in bits 18-19.
+static const uint32_t ENCODE_ARRAY_TYPED_MASK = 0x3 << 16;
+static const uint32_t ENCODE_DICTIONARY_TYPED_MASK = 0xF << 16;
+
+static const bool REAL_IS_64 = sizeof(godot::real_t) == 8;
+
+namespace {
+
+struct Writer {
+	std::vector<uint8_t> &buf;
+
+	template <typename T>
+	void put(T p_value) {
+		size_t pos = buf.size();
+		buf.resize(pos + sizeof(T));
+		memcpy(buf.data() + pos, &p_value, sizeof(T));
+	}
+
+	void put_real(godot::real_t p_value) {
+		put(p_value);
+	}
+
+	void put_reals(const godot::real_t *p_values, size_t p_count) {
+		size_t pos = buf.size();
+		buf.resize(pos + p_count * sizeof(godot::real_t));
+		memcpy(buf.data() + pos, p_values, p_count * sizeof(godot::real_t));
+	}
+
+	void put_bytes(const void *p_data, size_t p_size) {
+		size_t pos = buf.size();
+		buf.resize(pos + p_size);
+		if (p_size) {
+			memcpy(buf.data() + pos, p_data, p_size);
+		}
+	}
+
+	void pad() {
+		while (buf.size() % 4) {
+			buf.push_back(0);
+		}
+	}
+
+	void put_string(const godot::String &p_string, bool p_null_terminated = false) {
+		godot::CharString utf8 = p_string.utf8();
+		uint32_t len = utf8.length() + (p_null_terminated ? 1 : 0);
+		put(len);
+		put_bytes(utf8.get_data(), len);
+		pad();
+	}
+};
+
+struct Reader {
+	const uint8_t *ptr;
+	const uint8_t *end;
+	bool ok = true;
+
+	bool has(size_t p_size) {
+		if ((size_t)(end - ptr) < p_size) {
+			ok = false;
+		}
+		return ok;
+	}
+
+	template <typename T>
+	T get() {
+		T value = T();
+		if (has(sizeof(T))) {
+			memcpy(&value, ptr, sizeof(T));
+			ptr += sizeof(T);
+		}
+		return value;
+	}
+
+	// Math types use real_t, which the writer may have stored as 64 bit.
+	godot::real_t get_real(bool p_64) {
+		return p_64 ? (godot::real_t)get<double>() : (godot::real_t)get<float>();
+	}
+
+	void skip_padding(const uint8_t *p_start) {
+		size_t used = ptr - p_start;
+		size_t padded = (used + 3) & ~(size_t)3;
+		if (has(padded - used)) {
+			ptr += padded - used;
+		}
+	}
+
+	godot::String get_string(bool p_null_terminated = false) {
+		const uint8_t *start = ptr;
+		uint32_t len = get<uint32_t>();
+		if (!has(len)) {
+			return godot::String();
+		}
+		uint32_t strLen = len;
+		if (p_null_terminated && strLen > 0 && ptr[strLen - 1] == 0) {
+			strLen--;
+		}
+		godot::String s = godot::String::utf8((const char *)ptr, strLen);
+		ptr += len;
+		skip_padding(start);
+		return s;
+	}
+};
+
+} // namespace
+
+static void encode_variant(const godot::Variant &p_variant, Writer &w) {
+	godot::Variant::Type type = p_variant.get_type();
+	uint32_t header = type;
+
+	switch (type) {
+		case godot::Variant::NIL: {
+			w.put(header);
+		} break;
+		case godot::Variant::BOOL: {
+			w.put(header);
+			w.put((uint32_t)(bool)p_variant);
+		} break;
+		case godot::Variant::INT: {
+			int64_t value = p_variant;
+			if (value > INT_MAX || value < INT_MIN) {
+				w.put(header | ENCODE_FLAG_64);
+				w.put(value);
+			} else {
+				w.put(header);
+				w.put((int32_t)value);
+			}
+		} break;
+		case godot::Variant::FLOAT: {
+			double value = p_variant;
+			float f = (float)value;
+			if ((double)f != value) {
+				w.put(header | ENCODE_FLAG_64);
+				w.put(value);
+			} else {
+				w.put(header);
+				w.put(f);
+			}
+		} break;
+		case godot::Variant::STRING:
+		case godot::Variant::STRING_NAME: {
+			w.put(header);
+			w.put_string(p_variant);
+		} break;
+		case godot::Variant::VECTOR2:
+		case godot::Variant::RECT2:
+		case godot::Variant::VECTOR3:
+		case godot::Variant::TRANSFORM2D:
+		case godot::Variant::VECTOR4:
+		case godot::Variant::PLANE:
+		case godot::Variant::QUATERNION:
+		case godot::Variant::AABB:
+		case godot::Variant::BASIS:
+		case godot::Variant::TRANSFORM3D:
+		case godot::Variant::PROJECTION: {
+			w.put(header | (REAL_IS_64 ? ENCODE_FLAG_64 : 0));
+			switch (type) {
+				case godot::Variant::VECTOR2: {
+					godot::Vector2 v = p_variant;
+					w.put_reals(&v.x, 2);
+				} break;
+				case godot::Variant::RECT2: {
+					godot::Rect2 r = p_variant;
+					w.put_reals(&r.position.x, 2);
+					w.put_reals(&r.size.x, 2);
+				} break;
+				case godot::Variant::VECTOR3: {
+					godot::Vector3 v = p_variant;
+					w.put_reals(&v.x, 3);
+				} break;
+				case godot::Variant::TRANSFORM2D: {
+					godot::Transform2D t = p_variant;
+					for (int i = 0; i < 3; ++i) {
+						w.put_reals(&t.columns[i].x, 2);
+					}
+				} break;
+				case godot::Variant::VECTOR4: {
+					godot::Vector4 v = p_variant;
+					w.put_reals(&v.x, 4);
+				} break;
+				case godot::Variant::PLANE: {
+					godot::Plane p = p_variant;
+					w.put_reals(&p.normal.x, 3);
+					w.put_real(p.d);
+				} break;
+				case godot::Variant::QUATERNION: {
+					godot::Quaternion q = p_variant;
+					w.put_reals(&q.x, 4);
+				} break;
+				case godot::Variant::AABB: {
+					godot::AABB a = p_variant;
+					w.put_reals(&a.position.x, 3);
+					w.put_reals(&a.size.x, 3);
+				} break;
+				case godot::Variant::BASIS: {
+					godot::Basis b = p_variant;
+					for (int i = 0; i < 3; ++i) {
+						w.put_reals(&b.rows[i].x, 3);
+					}
+				} break;
+				case godot::Variant::TRANSFORM3D: {
+					godot::Transform3D t = p_variant;
+					for (int i = 0; i < 3; ++i) {
+						w.put_reals(&t.basis.rows[i].x, 3);
+					}
+					w.put_reals(&t.origin.x, 3);
+				} break;
+				case godot::Variant::PROJECTION: {
+					godot::Projection p = p_variant;
+					for (int i = 0; i < 4; ++i) {
+						w.put_reals(&p.columns[i].x, 4);
+					}
+				} break;
+				default:
+					break;
+			}
+		} break;
+		case godot::Variant::VECTOR2I: {
+			godot::Vector2i v = p_variant;
+			w.put(header);
+			w.put(v.x);
+			w.put(v.y);
+		} break;
+		case godot::Variant::RECT2I: {
+			godot::Rect2i r = p_variant;
+			w.put(header);
+			w.put(r.position.x);
+			w.put(r.position.y);
+			w.put(r.size.x);
+			w.put(r.size.y);
+		} break;
+		case godot::Variant::VECTOR3I: {
+			godot::Vector3i v = p_variant;
+			w.put(header);
+			w.put(v.x);
+			w.put(v.y);
+			w.put(v.z);
+		} break;
+		case godot::Variant::VECTOR4I: {
+			godot::Vector4i v = p_variant;
+			w.put(header);
+			w.put(v.x);
+			w.put(v.y);
+			w.put(v.z);
+			w.put(v.w);
+		} break;
+		case godot::Variant::COLOR: {
+			godot::Color c = p_variant;
+			w.put(header);
+			w.put(c.r);
+			w.put(c.g);
+			w.put(c.b);
+			w.put(c.a);
+		} break;
+		case godot::Variant::NODE_PATH: {
+			godot::NodePath np = p_variant;
+			w.put(header);
+			w.put((uint32_t)np.get_name_count() | 0x80000000);
+			w.put((uint32_t)np.get_subname_count());
+			w.put((uint32_t)(np.is_absolute() ? 1 : 0));
+			for (int i = 0; i < np.get_name_count(); ++i) {
+				w.put_string(np.get_name(i));
+			}
+			for (int i = 0; i < np.get_subname_count(); ++i) {
+				w.put_string(np.get_subname(i));
+			}
+		} break;
+		case godot::Variant::RID: {
+			godot::RID rid = p_variant;
+			w.put(header);
+			w.put((uint64_t)rid.get_id());
+		} break;
+		case godot::Variant::OBJECT: {
+			// Null objects are written as id 0, bytes_to_var() decodes that to a null Object.
+			godot::Object *object = p_variant;
+			w.put(header | ENCODE_FLAG_OBJECT_AS_ID);
+			w.put(object ? (uint64_t)object->get_instance_id() : (uint64_t)0);
+		} break;
+		case godot::Variant::CALLABLE: {
+			// Like var_to_bytes(), only the type is written.
+			w.put(header);
+		} break;
+		case godot::Variant::SIGNAL: {
+			godot::Signal signal = p_variant;
+			w.put(header);
+			w.put_string(godot::String(signal.get_name()));
+			w.put((uint64_t)signal.get_object_id());
+		} break;
+		case godot::Variant::DICTIONARY: {
+			godot::Dictionary d = p_variant;
+			godot::Array keys = d.keys();
+			w.put(header);
+			w.put((uint32_t)keys.size());
+			for (int i = 0; i < keys.size(); ++i) {
+				const godot::Variant &key = keys[i];
+				encode_variant(key, w);
+				encode_variant(d[key], w);
+			}
+		} break;
+		case godot::Variant::ARRAY: {
+			godot::Array a = p_variant;
+			w.put(header);
+			w.put((uint32_t)a.size());
+			for (int i = 0; i < a.size(); ++i) {
+				encode_variant(a[i], w);
+			}
+		} break;
+		case godot::Variant::PACKED_BYTE_ARRAY: {
+			godot::PackedByteArray a = p_variant;
+			w.put(header);
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size());
+			w.pad();
+		} break;
+		case godot::Variant::PACKED_INT32_ARRAY: {
+			godot::PackedInt32Array a = p_variant;
+			w.put(header);
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size() * sizeof(int32_t));
+		} break;
+		case godot::Variant::PACKED_INT64_ARRAY: {
+			godot::PackedInt64Array a = p_variant;
+			w.put(header);
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size() * sizeof(int64_t));
+		} break;
+		case godot::Variant::PACKED_FLOAT32_ARRAY: {
+			godot::PackedFloat32Array a = p_variant;
+			w.put(header);
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size() * sizeof(float));
+		} break;
+		case godot::Variant::PACKED_FLOAT64_ARRAY: {
+			godot::PackedFloat64Array a = p_variant;
+			w.put(header);
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size() * sizeof(double));
+		} break;
+		case godot::Variant::PACKED_STRING_ARRAY: {
+			godot::PackedStringArray a = p_variant;
+			w.put(header);
+			w.put((uint32_t)a.size());
+			for (int i = 0; i < a.size(); ++i) {
+				w.put_string(a[i], true);
+			}
+		} break;
+		case godot::Variant::PACKED_VECTOR2_ARRAY: {
+			godot::PackedVector2Array a = p_variant;
+			w.put(header | (REAL_IS_64 ? ENCODE_FLAG_64 : 0));
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size() * sizeof(godot::Vector2));
+		} break;
+		case godot::Variant::PACKED_VECTOR3_ARRAY: {
+			godot::PackedVector3Array a = p_variant;
+			w.put(header | (REAL_IS_64 ? ENCODE_FLAG_64 : 0));
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size() * sizeof(godot::Vector3));
+		} break;
+		case godot::Variant::PACKED_COLOR_ARRAY: {
+			godot::PackedColorArray a = p_variant;
+			w.put(header);
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size() * sizeof(godot::Color));
+		} break;
+		case godot::Variant::PACKED_VECTOR4_ARRAY: {
+			godot::PackedVector4Array a = p_variant;
+			w.put(header | (REAL_IS_64 ? ENCODE_FLAG_64 : 0));
+			w.put((uint32_t)a.size());
+			w.put_bytes(a.ptr(), a.size() * sizeof(godot::Vector4));
+		} break;
+		default: {
+			w.put((uint32_t)godot::Variant::NIL);
+		} break;
+	}
+}
+
+void VariantCodec::encode(const godot::Variant &p_variant, std::vector<uint8_t> &r_buffer) {
+	Writer w{ r_buffer };
+	encode_variant(p_variant, w);
+}
+
+template <typename T>
+static T decode_packed(Reader &r, size_t p_element_size, uint32_t p_count, bool p_64 = false) {
+	// Packed arrays of real_t elements may have been written with another real_t size.
+	T array;
+	size_t storedSize = p_64 != REAL_IS_64 ? p_element_size / sizeof(godot::real_t) * (p_64 ? 8 : 4) : p_element_size;
+	if (!r.has((size_t)p_count * storedSize)) {
+		return array;
+	}
+	array.resize(p_count);
+	if (storedSize == p_element_size) {
+		memcpy((void *)array.ptrw(), r.ptr, (size_t)p_count * p_element_size);
+		r.ptr += (size_t)p_count * p_element_size;
+	} else {
+		godot::real_t *dst = (godot::real_t *)array.ptrw();
+		size_t components = (size_t)p_count * (p_element_size / sizeof(godot::real_t));
+		for (size_t i = 0; i < components; ++i) {
+			dst[i] = r.get_real(p_64);
+		}
+	}
+	return array;
+}
+
+// Decodes one encoded value with bytes_to_var(), for types that cannot be
+// built through GDExtension.
+static godot::Variant decode_with_engine(const uint8_t *p_start, const uint8_t *p_end) {
+	godot::PackedByteArray bytes;
+	bytes.resize(p_end - p_start);
+	memcpy(bytes.ptrw(), p_start, p_end - p_start);
+	return godot::UtilityFunctions::bytes_to_var(bytes);
+}
+
+static godot::Variant decode_variant(Reader &r, int p_depth) {
+	if (p_depth > 512) {
+		// Same limit as Godot, protects against stack overflows with malicious data.
+		r.ok = false;
+		return godot::Variant();
+	}
+	const uint8_t *start = r.ptr;
+	uint32_t header = r.get<uint32_t>();
+	if (!r.ok) {
+		return godot::Variant();
+	}
+	uint32_t type = header & ENCODE_MASK;
+	bool is64 = (header & ENCODE_FLAG_64) != 0;
+
+	switch (type) {
+		case godot::Variant::NIL:
+			return godot::Variant();
+		case godot::Variant::BOOL:
+			return godot::Variant(r.get<uint32_t>() != 0);
+		case godot::Variant::INT:
+			return godot::Variant(is64 ? r.get<int64_t>() : (int64_t)r.get<int32_t>());
+		case godot::Variant::FLOAT:
+			return godot::Variant(is64 ? r.get<double>() : (double)r.get<float>());
+		case godot::Variant::STRING:
+			return godot::Variant(r.get_string());
+		case godot::Variant::STRING_NAME:
+			return godot::Variant(godot::StringName(r.get_string()));
+		case godot::Variant::VECTOR2: {
+			godot::real_t x = r.get_real(is64);
+			godot::real_t y = r.get_real(is64);
+			return godot::Variant(godot::Vector2(x, y));
+		}
+		case godot::Variant::VECTOR2I: {
+			int32_t x = r.get<int32_t>();
+			int32_t y = r.get<int32_t>();
+			return godot::Variant(godot::Vector2i(x, y));
+		}
+		case godot::Variant::RECT2: {
+			godot::real_t v[4];
+			for (int i = 0; i < 4; ++i) {
+				v[i] = r.get_real(is64);
+			}
+			return godot::Variant(godot::Rect2(v[0], v[1], v[2], v[3]));
+		}
+		case godot::Variant::RECT2I: {
+			int32_t v[4];
+			for (int i = 0; i < 4; ++i) {
+				v[i] = r.get<int32_t>();
+			}
+			return godot::Variant(godot::Rect2i(v[0], v[1], v[2], v[3]));
+		}
+		case godot::Variant::VECTOR3: {
+			godot::real_t v[3];
+			for (int i = 0; i < 3; ++i) {
+				v[i] = r.get_real(is64);
+			}
+			return godot::Variant(godot::Vector3(v[0], v[1], v[2]));
+		}
+		case godot::Variant::VECTOR3I: {
+			int32_t v[3];
+			for (int i = 0; i < 3; ++i) {
+				v[i] = r.get<int32_t>();
+			}
+			return godot::Variant(godot::Vector3i(v[0], v[1], v[2]));
+		}
+		case godot::Variant::TRANSFORM2D: {
+			godot::Transform2D t;
+			for (int i = 0; i < 3; ++i) {
+				t.columns[i].x = r.get_real(is64);
+				t.columns[i].y = r.get_real(is64);
+			}
+			return godot::Variant(t);
+		}
+		case godot::Variant::VECTOR4: {
+			godot::real_t v[4];
+			for (int i = 0; i < 4; ++i) {
+				v[i] = r.get_real(is64);
+			}
+			return godot::Variant(godot::Vector4(v[0], v[1], v[2], v[3]));
+		}
+		case godot::Variant::VECTOR4I: {
+			int32_t v[4];
+			for (int i = 0; i < 4; ++i) {
+				v[i] = r.get<int32_t>();
+			}
+			return godot::Variant(godot::Vector4i(v[0], v[1], v[2], v[3]));
+		}
+		case godot::Variant::PLANE: {
+			godot::real_t v[4];
+			for (int i = 0; i < 4; ++i) {
+				v[i] = r.get_real(is64);
+			}
+			return godot::Variant(godot::Plane(v[0], v[1], v[2], v[3]));
+		}
+		case godot::Variant::QUATERNION: {
+			godot::real_t v[4];
+			for (int i = 0; i < 4; ++i) {
+				v[i] = r.get_real(is64);
+			}
+			return godot::Variant(godot::Quaternion(v[0], v[1], v[2], v[3]));
+		}
+		case godot::Variant::AABB: {
+			godot::real_t v[6];
+			for (int i = 0; i < 6; ++i) {
+				v[i] = r.get_real(is64);
+			}
+			return godot::Variant(godot::AABB(godot::Vector3(v[0], v[1], v[2]), godot::Vector3(v[3], v[4], v[5])));
+		}
+		case godot::Variant::BASIS: {
+			godot::Basis b;
+			for (int i = 0; i < 3; ++i) {
+				for (int j = 0; j < 3; ++j) {
+					b.rows[i][j] = r.get_real(is64);
+				}
+			}
+			return godot::Variant(b);
+		}
+		case godot::Variant::TRANSFORM3D: {
+			godot::Transform3D t;
+			for (int i = 0; i < 3; ++i) {
+				for (int j = 0; j < 3; ++j) {
+					t.basis.rows[i][j] = r.get_real(is64);
+				}
+			}
+			for (int j = 0; j < 3; ++j) {
+				t.origin[j] = r.get_real(is64);
+			}
+			return godot::Variant(t);
+		}
+		case godot::Variant::PROJECTION: {
+			godot::Projection p;
+			for (int i = 0; i < 4; ++i) {
+				for (int j = 0; j < 4; ++j) {
+					p.columns[i][j] = r.get_real(is64);
+				}
+			}
+			return godot::Variant(p);
+		}
+		case godot::Variant::COLOR: {
+			float v[4];
+			for (int i = 0; i < 4; ++i) {
+				v[i] = r.get<float>();
+			}
+			return godot::Variant(godot::Color(v[0], v[1], v[2], v[3]));
+		}
+		case godot::Variant::NODE_PATH: {
+			uint32_t nameCount = r.get<uint32_t>();
+			if (!(nameCount & 0x80000000)) {
+				// Old format, not written by Godot 4.
+				r.ok = false;
+				return godot::Variant();
+			}
+			nameCount &= 0x7FFFFFFF;
+			uint32_t subnameCount = r.get<uint32_t>();
+			uint32_t flags = r.get<uint32_t>();
+			godot::String path = (flags & 1) ? "/" : "";
+			for (uint32_t i = 0; i < nameCount && r.ok; ++i) {
+				if (i > 0) {
+					path += "/";
+				}
+				path += r.get_string();
+			}
+			for (uint32_t i = 0; i < subnameCount && r.ok; ++i) {
+				path += ":";
+				path += r.get_string();
+			}
+			return godot::Variant(godot::NodePath(path));
+		}
+		case godot::Variant::RID: {
+			// RIDs cannot be created from their id through GDExtension, the
+			// engine decodes them.
+			r.get<uint64_t>();
+			if (!r.ok) {
+				return godot::Variant();
+			}
+			return decode_with_engine(start, r.ptr);
+		}
+		case godot::Variant::OBJECT: {
+			if (!(header & ENCODE_FLAG_OBJECT_AS_ID)) {
+				// Full objects are not supported.
+				r.ok = false;
+				return godot::Variant();
+			}
+			// Unlike bytes_to_var(), which returns an EncodedObjectAsID, the id
+			// is resolved to the live object. Id 0 and ids of freed objects
+			// decode to a null Object.
+			uint64_t id = r.get<uint64_t>();
+			if (id == 0) {
+				return godot::Variant((godot::Object *)nullptr);
+			}
+			return godot::Variant(godot::ObjectDB::get_instance(id));
+		}
+		case godot::Variant::CALLABLE:
+			return godot::Variant(godot::Callable());
+		case godot::Variant::SIGNAL: {
+			// Decoded by the engine too, which keeps the id of a freed
+			// emitter like bytes_to_var() does.
+			r.get_string();
+			r.get<uint64_t>();
+			if (!r.ok) {
+				return godot::Variant();
+			}
+			return decode_with_engine(start, r.ptr);
+		}
+		case godot::Variant::DICTIONARY: {
+			if (header & ENCODE_DICTIONARY_TYPED_MASK) {
+				// Typed dictionaries carry their key and value types first, not written by encode().
+				r.ok = false;
+				return godot::Variant();
+			}
+			uint32_t count = r.get<uint32_t>() & 0x7FFFFFFF;
+			godot::Dictionary d;
+			for (uint32_t i = 0; i < count && r.ok; ++i) {
+				godot::Variant key = decode_variant(r, p_depth + 1);
+				godot::Variant value = decode_variant(r, p_depth + 1);
+				d[key] = value;
+			}
+			return godot::Variant(d);
+		}
+		case godot::Variant::ARRAY: {
+			if (header & ENCODE_ARRAY_TYPED_MASK) {
+				// Typed arrays carry their element type first, not written by encode().
+				r.ok = false;
+				return godot::Variant();
+			}
+			uint32_t count = r.get<uint32_t>() & 0x7FFFFFFF;
+			godot::Array a;
+			if (r.has((size_t)count * 4)) {
+				a.resize(count);
+			}
+			for (uint32_t i = 0; i < count && r.ok; ++i) {
+				a[i] = decode_variant(r, p_depth + 1);
+			}
+			return godot::Variant(a);
+		}
+		case godot::Variant::PACKED_BYTE_ARRAY: {
+			const uint8_t *start = r.ptr;
+			uint32_t count = r.get<uint32_t>();
+			godot::PackedByteArray a = decode_packed<godot::PackedByteArray>(r, 1, count);
+			r.skip_padding(start);
+			return godot::Variant(a);
+		}
+		case godot::Variant::PACKED_INT32_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			return godot::Variant(decode_packed<godot::PackedInt32Array>(r, sizeof(int32_t), count));
+		}
+		case godot::Variant::PACKED_INT64_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			return godot::Variant(decode_packed<godot::PackedInt64Array>(r, sizeof(int64_t), count));
+		}
+		case godot::Variant::PACKED_FLOAT32_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			return godot::Variant(decode_packed<godot::PackedFloat32Array>(r, sizeof(float), count));
+		}
+		case godot::Variant::PACKED_FLOAT64_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			return godot::Variant(decode_packed<godot::PackedFloat64Array>(r, sizeof(double), count));
+		}
+		case godot::Variant::PACKED_STRING_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			godot::PackedStringArray a;
+			for (uint32_t i = 0; i < count && r.ok; ++i) {
+				a.push_back(r.get_string(true));
+			}
+			return godot::Variant(a);
+		}
+		case godot::Variant::PACKED_VECTOR2_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			return godot::Variant(decode_packed<godot::PackedVector2Array>(r, sizeof(godot::Vector2), count, is64));
+		}
+		case godot::Variant::PACKED_VECTOR3_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			return godot::Variant(decode_packed<godot::PackedVector3Array>(r, sizeof(godot::Vector3), count, is64));
+		}
+		case godot::Variant::PACKED_COLOR_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			return godot::Variant(decode_packed<godot::PackedColorArray>(r, sizeof(godot::Color), count));
+		}
+		case godot::Variant::PACKED_VECTOR4_ARRAY: {
+			uint32_t count = r.get<uint32_t>();
+			return godot::Variant(decode_packed<godot::PackedVector4Array>(r, sizeof(godot::Vector4), count, is64));
+		}
+		default: {
+			r.ok = false;
+			return godot::Variant();
+		}
+	}
+}
+
+bool VariantCodec::decode(const uint8_t *p_data, size_t p_size, godot::Variant &r_variant, size_t &r_used) {
+	Reader r{ p_data, p_data + p_size };
+	r_variant = decode_variant(r, 0);
+	r_used = r.ptr - p_data;
+	return r.ok;
+}
@@ -0,0 +1,52 @@
+/**************************************************************************/
+/*  VariantCodec.h                                                        */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <godot_cpp/variant/variant.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Binary encoding of Variants in the format of Godot's var_to_bytes()
+// (without full objects, objects are encoded as their ObjectID), so the
+// bytes can also be passed to bytes_to_var() in GDScript.
+//
+// Object ids decode to the live object rather than to an EncodedObjectAsID,
+// id 0 and ids of freed objects decode to a null Object.
+//
+// Typed arrays and dictionaries are encoded untyped. Signals are written as
+// their name and the id of their object, like var_to_bytes() does, Callables
+// only as their type and decode to an empty Callable.
+class VariantCodec {
+public:
+	// Appends the encoding of p_variant to r_buffer.
+	static void encode(const godot::Variant &p_variant, std::vector<uint8_t> &r_buffer);
+
+	// Decodes one Variant from p_data. Returns false if the data is
+	// truncated or malformed, r_used is set to the number of bytes read.
+	static bool decode(const uint8_t *p_data, size_t p_size, godot::Variant &r_variant, size_t &r_used);
+};
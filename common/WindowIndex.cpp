@@ -0,0 +1,64 @@
+/**************************************************************************/
+/*  WindowIndex.cpp                                                       */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "WindowIndex.h"
+
+void WindowIndex::add(uint64_t p_id, const std::string &p_name) {
+	if (_names.contains(p_id)) {
+		return;
+	}
+	_ids[p_name].push_back(p_id);
+	_names[p_id] = p_name;
+}
+
+void WindowIndex::remove(uint64_t p_id) {
+	auto it = _names.find(p_id);
+	if (it == _names.end()) {
+		return;
+	}
+	auto iit = _ids.find(it->second);
+	if (iit != _ids.end()) {
+		std::erase(iit->second, p_id);
+		if (iit->second.empty()) {
+			_ids.erase(iit);
+		}
+	}
+	_names.erase(it);
+}
+
+void WindowIndex::rename(uint64_t p_id, const std::string &p_name) {
+	remove(p_id);
+	add(p_id, p_name);
+}
+
+const std::vector<uint64_t> *WindowIndex::find(const std::string &p_name) const {
+	auto it = _ids.find(p_name);
+	return it == _ids.end() ? nullptr : &it->second;
+}
+
+void WindowIndex::clear() {
+	_ids.clear();
+	_names.clear();
+}
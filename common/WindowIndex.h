@@ -0,0 +1,54 @@
+/**************************************************************************/
+/*  WindowIndex.h                                                         */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Name to instance id index behind WindowRegistry, without the engine
+// parts. Names are not unique in a SceneTree, the ids of a name are kept in
+// the order they were added and the first live one wins. Not thread safe.
+class WindowIndex {
+	std::unordered_map<std::string, std::vector<uint64_t>> _ids;
+	std::unordered_map<uint64_t, std::string> _names;
+
+public:
+	bool contains(uint64_t p_id) const { return _names.contains(p_id); }
+
+	// Does nothing if p_id is already indexed.
+	void add(uint64_t p_id, const std::string &p_name);
+	void remove(uint64_t p_id);
+	void rename(uint64_t p_id, const std::string &p_name);
+
+	// Ids registered under p_name, nullptr if there are none.
+	const std::vector<uint64_t> *find(const std::string &p_name) const;
+
+	size_t size() const { return _names.size(); }
+	void clear();
+};
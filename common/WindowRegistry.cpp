@@ -0,0 +1,157 @@
+/**************************************************************************/
+/*  WindowRegistry.cpp                                                    */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "WindowRegistry.h"
+#define LOG_TAG "WindowRegistry"
+#include "godot-log.h"
+
+#include "GodotModule.h"
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/main_loop.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/core/object.hpp>
+
+WindowRegistry *WindowRegistry::get_singleton() {
+	static WindowRegistry *singleton = new WindowRegistry();
+	return singleton;
+}
+
+static godot::Window *get_window_argument(const godot::Variant **p_arguments, int p_argcount) {
+	if (p_argcount < 1) {
+		return nullptr;
+	}
+	return godot::Object::cast_to<godot::Window>((godot::Object *)*p_arguments[0]);
+}
+
+bool WindowRegistry::attach() {
+	godot::MainLoop *mainLoop = godot::Engine::get_singleton()->get_main_loop();
+	godot::SceneTree *sceneTree = godot::Object::cast_to<godot::SceneTree>(mainLoop);
+	if (!sceneTree) {
+		LOGE("Unable to get SceneTree from Godot!");
+		return false;
+	}
+	uint64_t treeId = sceneTree->get_instance_id();
+	if (treeId == _tree_id) {
+		return true;
+	}
+
+	// New SceneTree (first lookup or the instance was recreated), rebuild the index.
+	_index.clear();
+
+	GodotModule *mod = GodotModule::get_singleton();
+	sceneTree->connect("node_added", mod->create_callable([this](const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) {
+		godot::Window *window = get_window_argument(p_arguments, p_argcount);
+		if (window) {
+			std::lock_guard lock(_mutex);
+			add_window(window);
+		}
+	}));
+	sceneTree->connect("node_removed", mod->create_callable([this](const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) {
+		godot::Window *window = get_window_argument(p_arguments, p_argcount);
+		if (window) {
+			std::lock_guard lock(_mutex);
+			remove_window(window->get_instance_id());
+		}
+	}));
+	sceneTree->connect("node_renamed", mod->create_callable([this](const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) {
+		godot::Window *window = get_window_argument(p_arguments, p_argcount);
+		if (window) {
+			std::lock_guard lock(_mutex);
+			rename_window(window);
+		}
+	}));
+
+	scan(sceneTree->get_root());
+	_tree_id = treeId;
+	return true;
+}
+
+static std::string get_window_name(godot::Window *window) {
+	return godot::String(window->get_name()).utf8().get_data();
+}
+
+void WindowRegistry::add_window(godot::Window *window) {
+	uint64_t id = window->get_instance_id();
+	if (_index.contains(id)) {
+		return;
+	}
+	_index.add(id, get_window_name(window));
+}
+
+void WindowRegistry::remove_window(uint64_t id) {
+	_index.remove(id);
+}
+
+void WindowRegistry::rename_window(godot::Window *window) {
+	_index.rename(window->get_instance_id(), get_window_name(window));
+}
+
+void WindowRegistry::scan(godot::Node *node) {
+	godot::TypedArray<godot::Node> children = node->get_children(true);
+	for (int i = 0; i < children.size(); ++i) {
+		godot::Node *child = godot::Object::cast_to<godot::Node>(children[i]);
+		if (!child) {
+			continue;
+		}
+		godot::Window *window = godot::Object::cast_to<godot::Window>(child);
+		if (window) {
+			add_window(window);
+		}
+		scan(child);
+	}
+}
+
+godot::Window *WindowRegistry::find_window(const std::string &name) {
+	std::lock_guard lock(_mutex);
+	if (!attach()) {
+		return nullptr;
+	}
+
+	if (name.find_first_of("*?") != std::string::npos) {
+		// Wildcard patterns cannot be indexed, use the SceneTree search instead.
+		godot::SceneTree *sceneTree = godot::Object::cast_to<godot::SceneTree>(godot::Engine::get_singleton()->get_main_loop());
+		godot::Node *node = sceneTree->get_root()->find_child(godot::String::utf8(name.c_str()), true, false);
+		return godot::Object::cast_to<godot::Window>(node);
+	}
+
+	const std::vector<uint64_t> *ids = _index.find(name);
+	if (!ids) {
+		return nullptr;
+	}
+	for (uint64_t id : *ids) {
+		godot::Window *window = godot::Object::cast_to<godot::Window>(godot::ObjectDB::get_instance(id));
+		if (window) {
+			return window;
+		}
+	}
+	LOGW("Stale Window entries for name: %s", name.c_str());
+	return nullptr;
+}
+
+void WindowRegistry::reset() {
+	std::lock_guard lock(_mutex);
+	_index.clear();
+	_tree_id = 0;
+}
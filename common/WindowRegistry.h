@@ -0,0 +1,70 @@
+/**************************************************************************/
+/*  WindowRegistry.h                                                      */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "WindowIndex.h"
+
+#include <godot_cpp/classes/window.hpp>
+
+#include <mutex>
+#include <string>
+
+// Indexes the Window nodes of the running SceneTree by name, so embedded
+// windows can be resolved without walking the whole tree with find_child().
+// The index follows the tree through its node_added / node_removed /
+// node_renamed signals.
+//
+// find_window() and the signal handlers run on the Godot thread. reset() is
+// called by destroy_instance(), which on Android and iOS runs on another
+// thread, the mutex guards the index against that.
+class WindowRegistry {
+	std::mutex _mutex;
+	uint64_t _tree_id = 0;
+	WindowIndex _index;
+
+	WindowRegistry() {}
+
+	bool attach();
+	void add_window(godot::Window *window);
+	void remove_window(uint64_t id);
+	void rename_window(godot::Window *window);
+	void scan(godot::Node *node);
+
+public:
+	static WindowRegistry *get_singleton();
+
+	// Returns the Window registered under the given name, or nullptr.
+	//
+	// Unlike find_child(), nodes that are not Windows are ignored, so a
+	// plain node with the same name earlier in the tree does not hide the
+	// Window. When several Windows share a name, the first one in tree order
+	// at the time of the first lookup wins, Windows added later come after
+	// it. Names with * or ? are still resolved with find_child().
+	godot::Window *find_window(const std::string &name);
+
+	// Drops the index, it is rebuilt on the next lookup.
+	void reset();
+};
@@ -29,17 +29,82 @@
 #error "You should define LOG_TAG before including this header"
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Log levels, same values as the Android log priorities.
+#define GODOT_LOG_LEVEL_VERBOSE 2
+#define GODOT_LOG_LEVEL_DEBUG 3
+#define GODOT_LOG_LEVEL_INFO 4
+#define GODOT_LOG_LEVEL_WARN 5
+#define GODOT_LOG_LEVEL_ERROR 6
+#define GODOT_LOG_LEVEL_SILENT 8
+
+// Logs below GODOT_LOG_MIN_LEVEL are compiled out, their arguments are not
+// evaluated. Release builds keep info and above, define GODOT_LOG_MIN_LEVEL
+// to override.
+#ifndef GODOT_LOG_MIN_LEVEL
+#if defined(NDEBUG) || (defined(__APPLE__) && !defined(DEBUG))
+#define GODOT_LOG_MIN_LEVEL GODOT_LOG_LEVEL_INFO
+#else
+#define GODOT_LOG_MIN_LEVEL GODOT_LOG_LEVEL_VERBOSE
+#endif
+#endif
+
+// Runtime level, changed with RTNGodot.setLogLevel(). Starts at the lowest
+// level, so only GODOT_LOG_MIN_LEVEL filters until it is changed. The
+// initializer must not depend on GODOT_LOG_MIN_LEVEL, which can differ
+// between translation units that share this variable.
+inline std::atomic<int> godot_log_level{ GODOT_LOG_LEVEL_VERBOSE };
+
+// Whether a level is compiled in, usable in if constexpr.
+#define GODOT_LOG_COMPILED(level) ((level) >= GODOT_LOG_MIN_LEVEL)
+
+#define GODOT_LOG_ENABLED(level) \
+	(GODOT_LOG_COMPILED(level) && (level) >= godot_log_level.load(std::memory_order_relaxed))
+
+#define GODOT_LOG(level, print, ...) \
+	do { \
+		if (GODOT_LOG_ENABLED(level)) { \
+			print(__VA_ARGS__); \
+		} \
+	} while (0)
+
+// Logs at most once per interval_ms from this call site, for hot paths.
+// Suppressed messages are not counted. The clock and the atomic are only
+// touched when the level is enabled, a level that is compiled out costs nothing.
+#define LOG_THROTTLED(level, interval_ms, ...) \
+	do { \
+		if constexpr (GODOT_LOG_COMPILED(level)) { \
+			if (GODOT_LOG_ENABLED(level)) { \
+				static std::atomic<int64_t> _log_last_ms{ INT64_MIN / 2 }; \
+				int64_t _log_now_ms = std::chrono::duration_cast<std::chrono::milliseconds>( \
+						std::chrono::steady_clock::now().time_since_epoch()) \
+											  .count(); \
+				int64_t _log_prev_ms = _log_last_ms.load(std::memory_order_relaxed); \
+				if (_log_now_ms - _log_prev_ms >= (interval_ms) && \
+						_log_last_ms.compare_exchange_strong(_log_prev_ms, _log_now_ms, std::memory_order_relaxed)) { \
+					GODOT_LOG_PRINT(level, __VA_ARGS__); \
+				} \
+			} \
+		} \
+	} while (0)
+
 #ifdef ANDROID
 
 #include <android/log.h>
 
-#define LOGV(...) __android_log_print(ANDROID_LOG_VERBOSE, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+// The levels are the Android log priorities.
+#define GODOT_LOG_PRINT(level, ...) __android_log_print(level, LOG_TAG, __VA_ARGS__)
 
-#else
+#define LOGV(...) GODOT_LOG(GODOT_LOG_LEVEL_VERBOSE, __android_log_print, ANDROID_LOG_VERBOSE, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) GODOT_LOG(GODOT_LOG_LEVEL_DEBUG, __android_log_print, ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) GODOT_LOG(GODOT_LOG_LEVEL_INFO, __android_log_print, ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) GODOT_LOG(GODOT_LOG_LEVEL_WARN, __android_log_print, ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) GODOT_LOG(GODOT_LOG_LEVEL_ERROR, __android_log_print, ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+#elif defined(__APPLE__)
 
 typedef enum ios_LogPriority {
 	ANDROID_LOG_UNKNOWN = 0,
@@ -55,10 +120,52 @@ typedef enum ios_LogPriority {
 
 void __ios_log_print(ios_LogPriority prio, const char *tag, ...);
 
-#define LOGV(...) __ios_log_print(IOS_LOG_VERBOSE, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __ios_log_print(IOS_LOG_VERBOSE, LOG_TAG, __VA_ARGS__)
-#define LOGI(...) __ios_log_print(IOS_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __ios_log_print(IOS_LOG_WARN, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __ios_log_print(IOS_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+// The levels match the ios_LogPriority values.
+#define GODOT_LOG_PRINT(level, ...) __ios_log_print((ios_LogPriority)(level), LOG_TAG, __VA_ARGS__)
+
+#define LOGV(...) GODOT_LOG(GODOT_LOG_LEVEL_VERBOSE, __ios_log_print, IOS_LOG_VERBOSE, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) GODOT_LOG(GODOT_LOG_LEVEL_DEBUG, __ios_log_print, IOS_LOG_VERBOSE, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) GODOT_LOG(GODOT_LOG_LEVEL_INFO, __ios_log_print, IOS_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) GODOT_LOG(GODOT_LOG_LEVEL_WARN, __ios_log_print, IOS_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) GODOT_LOG(GODOT_LOG_LEVEL_ERROR, __ios_log_print, IOS_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+#else
+
+// Host builds (e.g. Linux) log to stderr.
+
+#include <cstdarg>
+#include <cstdio>
+
+inline void host_log_print(const char *level, const char *tag, const char *format, ...) {
+	va_list ap;
+	va_start(ap, format);
+	fprintf(stderr, "%s/%s: ", level, tag);
+	vfprintf(stderr, format, ap);
+	fputc('\n', stderr);
+	va_end(ap);
+}
+
+inline const char *host_log_level_name(int level) {
+	switch (level) {
+		case GODOT_LOG_LEVEL_VERBOSE:
+			return "V";
+		case GODOT_LOG_LEVEL_DEBUG:
+			return "D";
+		case GODOT_LOG_LEVEL_INFO:
+			return "I";
+		case GODOT_LOG_LEVEL_WARN:
+			return "W";
+		default:
+			return "E";
+	}
+}
+
+#define GODOT_LOG_PRINT(level, ...) host_log_print(host_log_level_name(level), LOG_TAG, __VA_ARGS__)
+
+#define LOGV(...) GODOT_LOG(GODOT_LOG_LEVEL_VERBOSE, host_log_print, "V", LOG_TAG, __VA_ARGS__)
+#define LOGD(...) GODOT_LOG(GODOT_LOG_LEVEL_DEBUG, host_log_print, "D", LOG_TAG, __VA_ARGS__)
+#define LOGI(...) GODOT_LOG(GODOT_LOG_LEVEL_INFO, host_log_print, "I", LOG_TAG, __VA_ARGS__)
+#define LOGW(...) GODOT_LOG(GODOT_LOG_LEVEL_WARN, host_log_print, "W", LOG_TAG, __VA_ARGS__)
+#define LOGE(...) GODOT_LOG(GODOT_LOG_LEVEL_ERROR, host_log_print, "E", LOG_TAG, __VA_ARGS__)
 
 #endif
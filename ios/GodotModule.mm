@@ -24,6 +24,10 @@
 /**************************************************************************/
 
 #import "GodotModule.h"
+#include "GodotEventStream.h"
+#include "SceneSnapshot.h"
+#include "StartupTrace.h"
+#include "WindowRegistry.h"
 
 #define LOG_TAG "GodotModule"
 #include "godot-log.h"
@@ -41,20 +45,41 @@
 #include <mutex>
 #include <string>
 
+class AppleThread;
+
 @interface GodotThread : NSObject
 
+- (instancetype)initWithExecutor:(AppleThread *)executor;
+
 // Method to start the thread and run loop
 - (void)start;
 
-// Method to submit blocks to the background thread for execution
-- (void)performBlock:(void (^)(void))block waitUntilDone:(bool)wait;
-
-- (void)scheduleBlock:(void (^)(void))block;
+// Method to make the thread run the queued tasks of the executor
+- (void)wake;
 
 - (void)step:(CADisplayLink *)sender;
 
 @end
 
+class AppleThread : public TaskExecutor {
+	GodotThread *_thread = nil;
+
+protected:
+	void wake() override {
+		[_thread wake];
+	}
+
+public:
+	AppleThread() {
+		_thread = [[GodotThread alloc] initWithExecutor:this];
+		[_thread start];
+	}
+
+	GodotThread *get_godot_thread() {
+		return _thread;
+	}
+};
+
 @interface GodotThread ()
 
 // Strong reference to the thread
@@ -65,7 +90,17 @@
 
 @end
 
-@implementation GodotThread
+@implementation GodotThread {
+	AppleThread *_executor;
+}
+
+- (instancetype)initWithExecutor:(AppleThread *)executor {
+	self = [super init];
+	if (self) {
+		_executor = executor;
+	}
+	return self;
+}
 
 // Method to start the background thread
 - (void)start {
@@ -77,6 +112,8 @@
 // Entry point of the background thread
 - (void)threadEntryPoint {
 	@autoreleasepool {
+		_executor->bind_current_thread();
+
 		// Set up the run loop
 		self.runLoopPort = [NSPort port];
 		[[NSRunLoop currentRunLoop] addPort:self.runLoopPort forMode:NSDefaultRunLoopMode];
@@ -86,35 +123,24 @@
 	}
 }
 
-// Method to perform a block on the background thread
-- (void)performBlock:(void (^)(void))block waitUntilDone:(bool)wait {
-	if (!block) {
-		return;
-	}
-
-	// Ensure the block is executed on the background thread
-	if ([[NSThread currentThread] isEqual:self.thread]) {
-		block();
-	} else {
-		[self performSelector:@selector(executeBlock:) onThread:self.thread withObject:[block copy] waitUntilDone:wait];
-	}
+- (void)wake {
+	[self performSelector:@selector(runPendingTasks) onThread:self.thread withObject:nil waitUntilDone:NO];
 }
 
-- (void)scheduleBlock:(void (^)(void))block {
-	if (!block) {
-		return;
+// Runs on the background thread
+- (void)runPendingTasks {
+	@autoreleasepool {
+		_executor->run_pending();
 	}
-
-	[self performSelector:@selector(executeBlock:) onThread:self.thread withObject:[block copy] waitUntilDone:FALSE];
-}
-
-// Helper method to execute the block on the background thread
-- (void)executeBlock:(void (^)(void))block {
-	block();
 }
 
 - (void)step:(CADisplayLink *)sender {
+	// targetTimestamp is when the next frame has to be ready, CACurrentMediaTime shares its clock.
+	CFTimeInterval remaining = std::max(0.0, sender.targetTimestamp - CACurrentMediaTime());
+	_executor->begin_frame(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(remaining)));
+	StartupTrace::mark(STARTUP_FIRST_FRAME_CALLBACK);
 	GodotModule::get_singleton()->iterate();
+	_executor->run_idle();
 }
 
 @end
@@ -137,12 +163,7 @@ struct ApplePlatformData : PlatformData {
 	std::map<void *, std::string> handleToWindowName;
 	std::mutex windowUpdateMutex;
 	std::mutex createMutex;
-	GodotThread *thread = nil;
-
-	ApplePlatformData() {
-		thread = [[GodotThread alloc] init];
-		[thread start];
-	}
+	AppleThread thread;
 };
 
 GodotModule *GodotModule::get_singleton() {
@@ -193,6 +214,10 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 		}
 	}
 
+	StartupTrace::begin();
+	// The arguments as requested, before the snapshot scene is added.
+	std::vector<std::string> requested_args = args;
+	SceneSnapshot::apply(args);
 	void *handle = nullptr;
 	if (data->func_libgodot_create_godot_instance == nullptr) {
 		handle = dlopen("libgodot.framework/libgodot", RTLD_LAZY | RTLD_LOCAL | RTLD_FIRST);
@@ -215,6 +240,8 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 		}
 	}
 
+	StartupTrace::mark(STARTUP_LIBRARY_LOADED);
+
 	godot::GodotInstance *instance = nullptr;
 
 	std::vector<std::string> cmdline{ [[[NSBundle mainBundle] executablePath] UTF8String] };
@@ -243,6 +270,7 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 	}
 
 	instance = reinterpret_cast<godot::GodotInstance *>(godot::internal::get_object_instance_binding(instance_ptr));
+	StartupTrace::mark(STARTUP_INSTANCE_CREATED);
 
 	CGRect screen = [[UIScreen mainScreen] bounds];
 	CGFloat contentScaleFactor = [[UIScreen mainScreen] scale];
@@ -261,13 +289,16 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 	godot::Ref<godot::RenderingNativeSurface> nativeSurface(ptr);
 
 	godot::DisplayServerEmbedded::set_native_surface(nativeSurface);
+	StartupTrace::mark(STARTUP_SURFACE_CREATED);
 
-	instance->start();
+	if (instance->start()) {
+		StartupTrace::mark(STARTUP_INSTANCE_STARTED);
+	}
 
 	{
 		std::lock_guard lock(_mutex);
 
-		data->displayLink = [CADisplayLink displayLinkWithTarget:data->thread
+		data->displayLink = [CADisplayLink displayLinkWithTarget:data->thread.get_godot_thread()
 														selector:@selector(step:)];
 		[data->displayLink addToRunLoop:[NSRunLoop currentRunLoop]
 								forMode:NSRunLoopCommonModes];
@@ -277,6 +308,7 @@ godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::strin
 		data->handle = handle;
 
 		_instance = instance;
+		_instance_args = requested_args;
 	}
 
 	updateWindows(true);
@@ -306,6 +338,9 @@ void GodotModule::destroy_instance() {
 		return;
 	}
 
+	// A snapshot save started on pause still calls into Godot.
+	SceneSnapshot::wait_for_saves();
+
 	if (!data->func_libgodot_destroy_godot_instance) {
 		libgodot_destroy_godot_instance_type func_libgodot_destroy_godot_instance = nullptr;
 		void *handle = nullptr;
@@ -346,8 +381,11 @@ void GodotModule::destroy_instance() {
 		data->mainWindowLayer = nil;
 		data->mainSurface = godot::Ref<godot::RenderingNativeSurface>(nullptr);
 
+		GodotEventStream::close_all();
 		data->func_libgodot_destroy_godot_instance(_instance->_owner);
 		_instance = nullptr;
+		_instance_args.clear();
+		WindowRegistry::get_singleton()->reset();
 		godot::GDExtensionBinding::deinit();
 
 		dlclose(data->handle);
@@ -371,12 +409,13 @@ void GodotModule::focus_out() {
 	std::lock_guard lock(_mutex);
 	ApplePlatformData *data = static_cast<ApplePlatformData *>(_data);
 	data->in_background = true;
-	[data->thread scheduleBlock:^{
+	data->thread.post([this]() {
 		std::lock_guard lock(_mutex);
 		if (_instance) {
 			_instance->focus_out();
 		}
-	}];
+	},
+			TASK_PRIORITY_URGENT);
 	updateState();
 }
 
@@ -384,12 +423,13 @@ void GodotModule::focus_in() {
 	std::lock_guard lock(_mutex);
 	ApplePlatformData *data = static_cast<ApplePlatformData *>(_data);
 	data->in_background = false;
-	[data->thread scheduleBlock:^{
+	data->thread.post([this]() {
 		std::lock_guard lock(_mutex);
 		if (_instance) {
 			_instance->focus_in();
 		}
-	}];
+	},
+			TASK_PRIORITY_URGENT);
 	updateState();
 }
 
@@ -406,25 +446,32 @@ void GodotModule::appPause() {
 
 	}];
 	data->in_background = true;
-	[data->thread scheduleBlock:^{
+	data->thread.post([this, bgTask]() {
 		std::lock_guard lock(_mutex);
-		if (_instance) {
-			_instance->pause();
+		if (!_instance) {
+			[[UIApplication sharedApplication] endBackgroundTask:bgTask];
+			return;
 		}
-		[[UIApplication sharedApplication] endBackgroundTask:bgTask];
-	}];
+		// The background task lasts until the snapshot is written.
+		SceneSnapshot::capture([bgTask]() {
+			[[UIApplication sharedApplication] endBackgroundTask:bgTask];
+		});
+		_instance->pause();
+	},
+			TASK_PRIORITY_URGENT);
 	updateState();
 }
 
 void GodotModule::appResume() {
 	std::lock_guard lock(_mutex);
 	ApplePlatformData *data = static_cast<ApplePlatformData *>(_data);
-	[data->thread scheduleBlock:^{
+	data->thread.post([this]() {
 		std::lock_guard lock(_mutex);
 		if (_instance) {
 			_instance->resume();
 		}
-	}];
+	},
+			TASK_PRIORITY_URGENT);
 	updateState();
 }
 
@@ -453,21 +500,23 @@ void GodotModule::updateState() {
 			[data->displayLink invalidate];
 			data->displayLink = nil;
 		}
+		// Without frames the background lane must not wait for a deadline.
+		data->thread.end_frames();
 	} else {
 		if (!data->displayLink) {
-			[data->thread scheduleBlock:^{
+			data->thread.post([this]() {
 				std::lock_guard lock(_mutex);
 				ApplePlatformData *data = static_cast<ApplePlatformData *>(_data);
 				if (!_instance) {
 					return;
 				}
 				if (!data->displayLink) {
-					data->displayLink = [CADisplayLink displayLinkWithTarget:data->thread
+					data->displayLink = [CADisplayLink displayLinkWithTarget:data->thread.get_godot_thread()
 																	selector:@selector(step:)];
 					[data->displayLink addToRunLoop:[NSRunLoop currentRunLoop]
 											forMode:NSRunLoopCommonModes];
 				}
-			}];
+			});
 		}
 	}
 }
@@ -569,13 +618,18 @@ void GodotModule::updateWindows(bool adding) {
 	}
 }
 
-void GodotModule::runOnGodotThread(std::function<void()> f, bool wait) {
+void GodotModule::runOnGodotThread(std::function<void()> f, bool wait, TaskPriority priority) {
+	ApplePlatformData *data = static_cast<ApplePlatformData *>(_data);
+	if (wait) {
+		data->thread.run_sync(f, priority);
+	} else {
+		data->thread.enqueue(std::move(f), priority);
+	}
+}
+
+TaskExecutor *GodotModule::get_thread() {
 	ApplePlatformData *data = static_cast<ApplePlatformData *>(_data);
-	[data->thread
-			 performBlock:^{
-				 f();
-			 }
-			waitUntilDone:wait];
+	return &data->thread;
 }
 
 void GodotModule::iterate() {
@@ -586,5 +640,6 @@ void GodotModule::iterate() {
 	}
 	if (instance && instance->is_started()) {
 		instance->iteration();
+		StartupTrace::mark(STARTUP_FIRST_ITERATION);
 	}
 }
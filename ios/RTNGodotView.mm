@@ -40,6 +40,7 @@
 #include <godot_cpp/variant/utility_functions.hpp>
 
 #include "GodotModule.h"
+#include "WindowRegistry.h"
 
 #import "RTNGodotView.h"
 
@@ -227,21 +228,14 @@ static UIView *_currentView = nil;
 				[self setNeedsLayout];
 				self->_addingGodotView = false;
 			});
-		});
+		},
+				false, TASK_PRIORITY_URGENT);
 
 	} else {
 		// Subwindow case
 		GodotModule::get_singleton()->runOnGodotThread([=]() {
-			godot::MainLoop *mainLoop = godot::Engine::get_singleton()->get_main_loop();
-			godot::SceneTree *sceneTree = godot::Object::cast_to<godot::SceneTree>(mainLoop);
-			if (!sceneTree) {
-				NSLog(@"RTNGodotView: Unable to get SceneTree from Godot!");
-				return;
-			}
-
 			std::string newWinName = [_windowName UTF8String];
-			godot::Node *node = sceneTree->get_root()->find_child(godot::String::utf8(newWinName.c_str()), true, false);
-			godot::Window *newWindow = godot::Object::cast_to<godot::Window>(node);
+			godot::Window *newWindow = WindowRegistry::get_singleton()->find_window(newWinName);
 
 			if (!newWindow) {
 				NSLog(@"RTNGodotView: Godot Window not valid: 0x%p", newWindow);
@@ -286,7 +280,8 @@ static UIView *_currentView = nil;
 				[self setNeedsLayout];
 				self->_addingGodotView = false;
 			});
-		});
+		},
+				false, TASK_PRIORITY_URGENT);
 	}
 }
 
@@ -383,7 +378,8 @@ static UIView *_currentView = nil;
 						}
 					}
 				}
-			});
+			},
+					false, TASK_PRIORITY_URGENT);
 		}
 	}
 }
@@ -448,7 +444,8 @@ static UIView *_currentView = nil;
 				godot::Window *window = godot::Object::cast_to<godot::Window>(obj);
 				dse->touch_press(touchId, location.x * contentScaleFactor, location.y * contentScaleFactor, true, tapCount > 1, window->get_window_id());
 			}
-		});
+		},
+				false, TASK_PRIORITY_URGENT);
 	}
 }
 
@@ -505,7 +502,8 @@ static UIView *_currentView = nil;
 						godot::Vector2(azim.dx * cos(alt), azim.dy * cos(alt)),
 						window->get_window_id());
 			}
-		});
+		},
+				false, TASK_PRIORITY_URGENT);
 	}
 }
 
@@ -545,7 +543,8 @@ static UIView *_currentView = nil;
 				godot::Window *window = godot::Object::cast_to<godot::Window>(obj);
 				dse->touch_press(touchId, location.x * contentScaleFactor, location.y * contentScaleFactor, false, false, window->get_window_id());
 			}
-		});
+		},
+				false, TASK_PRIORITY_URGENT);
 	}
 }
 
@@ -578,7 +577,8 @@ static UIView *_currentView = nil;
 				godot::Window *window = godot::Object::cast_to<godot::Window>(obj);
 				dse->touches_canceled(touchId, window->get_window_id());
 			}
-		});
+		},
+				false, TASK_PRIORITY_URGENT);
 	}
 }
 
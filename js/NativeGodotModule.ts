@@ -25,6 +25,7 @@
 
 import { TurboModule, TurboModuleRegistry } from "react-native";
 import { IWorkletContext, Worklets } from "react-native-worklets-core";
+import type { GodotStateChannel, GodotStateLayout } from "./StateChannel";
 
 export interface Spec extends TurboModule {
   installTurboModule(): boolean;
@@ -33,6 +34,172 @@ export interface Spec extends TurboModule {
 const GodotInstaller =
   TurboModuleRegistry.getEnforcing<Spec>("NativeGodotModule");
 
+export interface GodotThreadConfig {
+  priority?: "default" | "high" | "realtime";
+  bigCores?: boolean;
+  frameReserveMs?: number;
+}
+
+export type GodotTaskPriority = "urgent" | "frame" | "background";
+
+// An ArrayBuffer is read as float64 values.
+export type GodotNumberArray =
+  | Float64Array
+  | Float32Array
+  | ArrayBuffer
+  | number[];
+
+// All values are counted in numbers, not bytes or elements.
+export interface GodotArrayLayout {
+  offset?: number;
+  stride?: number;
+  count?: number;
+}
+
+export type GodotLogLevel =
+  | "verbose"
+  | "debug"
+  | "info"
+  | "warn"
+  | "error"
+  | "silent";
+
+export interface GodotTaskStats {
+  count: number;
+  totalLatencyNs: number;
+  maxLatencyNs: number;
+  lastLatencyNs: number;
+  deferred: number;
+}
+
+export interface GodotThreadStats extends GodotTaskStats {
+  lanes: Record<GodotTaskPriority, GodotTaskStats>;
+  // Round trips of blocking calls from other threads.
+  sync: GodotTaskStats;
+  // Heap blocks allocated for call arguments, since startup. Calls with a
+  // few arguments are served from a per-thread arena without allocating.
+  arena: { heapAllocations: number; highWaterBytes: number };
+  preload: GodotPreloadStats;
+}
+
+export type GodotPreloadPriority = "high" | "normal" | "low";
+
+export interface GodotPreloadOptions {
+  typeHint?: string;
+  priority?: GodotPreloadPriority; // Default: "normal"
+  useSubThreads?: boolean; // Default: false
+}
+
+export interface GodotPreloadHandle {
+  path: string;
+  // Resolves to the loaded Resource.
+  promise: Promise<any>;
+  // Both are read without crossing to the Godot thread, cheap to poll per frame.
+  progress(): number;
+  status(): "queued" | "loading" | "loaded" | "failed";
+}
+
+export interface GodotPreloadStats {
+  requested: number;
+  loaded: number;
+  failed: number;
+  active: number;
+  queued: number;
+  maxConcurrent: number;
+  totalLoadNs: number;
+  maxLoadNs: number;
+  lastLoadNs: number;
+  // Time spent waiting for a free load slot.
+  totalWaitNs: number;
+}
+
+export interface GodotShaderCacheStats {
+  enabled: boolean; // rendering/shader_compiler/shader_cache/enabled
+  bytes: number;
+  files: number;
+  // Files present when the instance started. Files added since then are
+  // shaders and pipelines that had to be compiled.
+  filesAtStart: number;
+  warmUps: number;
+  warmed: number;
+  warmUpNs: number;
+}
+
+export interface GodotWarmUpResult {
+  drawn: number;
+  failed: number;
+  ms: number;
+}
+
+export type GodotStartupPhase =
+  | "libraryLoaded"
+  | "instanceCreated"
+  | "surfaceCreated"
+  | "instanceStarted" // The main scene is loaded.
+  | "firstFrameCallback"
+  | "firstIteration";
+
+export interface GodotStartupReport {
+  beginNs: number; // Monotonic clock when createInstance started.
+  // Time since beginNs, phases not reached yet are missing.
+  phasesNs: Partial<Record<GodotStartupPhase, number>>;
+  complete: boolean;
+  fromSnapshot: boolean; // Started from a scene snapshot, see setSnapshotConfig().
+}
+
+export interface GodotEventStreamOptions {
+  capacity?: number; // Default: 256, at most 65536
+  overflow?: "dropOldest" | "coalesce" | "block"; // Default: "dropOldest"
+  blockTimeoutMs?: number; // Default: 100, at most 10000, only used by "block"
+}
+
+export interface GodotEvent {
+  signal: string;
+  signalId: number;
+  source: bigint; // ObjectID of the emitter
+  args: any[];
+}
+
+export interface GodotEventStreamStats {
+  pushed: number;
+  dropped: number;
+  coalesced: number;
+  blocked: number;
+  invalid: number; // Drained events whose arguments could not be converted
+  pending: number;
+  capacity: number;
+}
+
+export interface GodotEventStream {
+  connect(object: any, signal: string): number;
+  drain(max?: number): GodotEvent[];
+  getStats(): GodotEventStreamStats;
+  close(): void;
+}
+
+export interface GodotBridgeMetric {
+  count: number;
+  nsPerOp: number;
+  p50Ns: number;
+  p99Ns: number;
+  maxNs: number;
+}
+
+export interface GodotBridgeStats {
+  enabled: boolean;
+  metrics: {
+    methodCall: GodotBridgeMetric;
+    staticCall: GodotBridgeMetric;
+    jsCallable: GodotBridgeMetric;
+    runOnGodotThread: GodotBridgeMetric;
+    typeLookup: GodotBridgeMetric;
+    toVariant: GodotBridgeMetric;
+    fromVariant: GodotBridgeMetric;
+    windowUpdate: GodotBridgeMetric;
+  };
+  arenaHeapAllocations: number;
+}
+
 export interface GodotModuleInterface {
   createInstance(args: Array<string>): any;
   getInstance(): any;
@@ -41,8 +208,46 @@ export interface GodotModuleInterface {
   pause(): void;
   resume(): void;
   is_paused(): boolean;
-  runOnGodotThread<T>(f: () => T): Promise<T>;
+  runOnGodotThread<T>(f: () => T, priority?: GodotTaskPriority): Promise<T>;
   destroyInstance(): void;
+  setThreadConfig(config: GodotThreadConfig): void;
+  getThreadStats(): GodotThreadStats;
+  preloadResource(
+    path: string,
+    options?: GodotPreloadOptions
+  ): GodotPreloadHandle;
+  setPreloadConfig(config: { maxConcurrent?: number }): void;
+  warmUpShaders(paths: string[]): Promise<GodotWarmUpResult>;
+  getShaderCacheStats(): Promise<GodotShaderCacheStats | null>;
+  getStartupReport(): GodotStartupReport;
+  writeStartupReport(path: string): boolean;
+  setSnapshotConfig(config: { path: string | null }): void;
+  discardSnapshot(): void;
+  // "java" if Godot reads the path through the Java FileAccessHandler
+  // (Android only), with one JNI call per read.
+  getFileRoute(path: string, directory?: boolean): "native" | "java";
+  setBridgeMetricsEnabled(enabled: boolean): void;
+  getBridgeStats(): GodotBridgeStats;
+  resetBridgeStats(): void;
+  setLogLevel(level: GodotLogLevel): void;
+  getLogLevel(): GodotLogLevel;
+  createStateChannel(name: string, layout: GodotStateLayout): GodotStateChannel;
+  releaseStateChannel(name: string): void;
+  createEventStream(options?: GodotEventStreamOptions): GodotEventStream;
+  encodeVariant(value: any): ArrayBuffer;
+  decodeVariant(buffer: ArrayBuffer, offset?: number): any;
+  toPackedFloat32Array(
+    source: GodotNumberArray,
+    layout?: GodotArrayLayout
+  ): any;
+  toPackedVector3Array(
+    source: GodotNumberArray,
+    layout?: GodotArrayLayout
+  ): any;
+  fromPackedArray(
+    packed: any,
+    options?: { target?: Float64Array; offset?: number; stride?: number }
+  ): Float64Array;
   crash(): void;
 }
 
@@ -81,8 +286,11 @@ if (globalThis.RTNGodot == null) {
 
 export const RTNGodot = globalThis.RTNGodot as GodotModuleInterface;
 
-export function runOnGodotThread<T>(f: () => T): Promise<T> {
+export function runOnGodotThread<T>(
+  f: () => T,
+  priority?: GodotTaskPriority
+): Promise<T> {
   console.log("Calling: runOnGodotThread");
   const worklet = f;
-  return globalThis.RTNGodot.runOnGodotThread(worklet);
+  return globalThis.RTNGodot.runOnGodotThread(worklet, priority);
 }
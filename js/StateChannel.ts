@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*  StateChannel.ts                                                       */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+export type GodotStateFieldType =
+  | "bool"
+  | "i32"
+  | "u32"
+  | "f32"
+  | "f64"
+  | "vec2"
+  | "vec3"
+  | "color";
+
+export type GodotStateLayout = Record<string, GodotStateFieldType>;
+
+type FieldValue<T extends GodotStateFieldType> = T extends "bool"
+  ? boolean
+  : T extends "vec2" | "vec3" | "color"
+  ? number[]
+  : number;
+
+export type GodotStateValues<L extends GodotStateLayout> = {
+  [K in keyof L]: FieldValue<L[K]>;
+};
+
+export interface GodotStateField {
+  name: string;
+  type: GodotStateFieldType;
+  offset: number;
+}
+
+export interface GodotStateChannel {
+  name: string;
+  // Shared with Godot, starts with the sequence number of the last write.
+  // Only the sequence number may be read from it directly, see read().
+  buffer: ArrayBuffer;
+  // Copy of the last completed write, filled by read().
+  snapshot: ArrayBuffer;
+  // Copies a consistent state into snapshot, false if Godot kept writing.
+  read(): boolean;
+  fields: GodotStateField[];
+  // Godot Callable, call it from Godot with the values in layout order,
+  // or with a Dictionary keyed by field name.
+  writer: any;
+}
+
+function readField(view: DataView, field: GodotStateField): any {
+  "worklet";
+  const o = field.offset;
+  switch (field.type) {
+    case "bool":
+      return view.getUint32(o, true) !== 0;
+    case "i32":
+      return view.getInt32(o, true);
+    case "u32":
+      return view.getUint32(o, true);
+    case "f32":
+      return view.getFloat32(o, true);
+    case "f64":
+      return view.getFloat64(o, true);
+    case "vec2":
+      return [view.getFloat32(o, true), view.getFloat32(o + 4, true)];
+    case "vec3":
+      return [
+        view.getFloat32(o, true),
+        view.getFloat32(o + 4, true),
+        view.getFloat32(o + 8, true),
+      ];
+    case "color":
+      return [
+        view.getFloat32(o, true),
+        view.getFloat32(o + 4, true),
+        view.getFloat32(o + 8, true),
+        view.getFloat32(o + 12, true),
+      ];
+  }
+}
+
+// Reads a consistent snapshot of the channel. The copy is made natively,
+// plain loads from the shared buffer are not ordered against the writer on
+// weakly ordered CPUs (arm64). Returns null if Godot kept writing.
+export function readStateChannel<L extends GodotStateLayout>(
+  channel: GodotStateChannel
+): GodotStateValues<L> | null {
+  "worklet";
+  if (!channel.read()) {
+    return null;
+  }
+  const view = new DataView(channel.snapshot);
+  const values: any = {};
+  for (const field of channel.fields) {
+    values[field.name] = readField(view, field);
+  }
+  return values;
+}
+
+// Sequence number of the last completed write, changes when there is new state.
+export function getStateChannelVersion(channel: GodotStateChannel): number {
+  "worklet";
+  return new DataView(channel.buffer).getUint32(0, true) >>> 1;
+}
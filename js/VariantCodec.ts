@@ -0,0 +1,608 @@
+/**************************************************************************/
+/*  VariantCodec.ts                                                       */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+// Decoder for the binary Variant format produced by RTNGodot.encodeVariant()
+// and Godot's var_to_bytes(). Arrays and dictionaries are decoded lazily:
+// an element is only decoded when it is accessed.
+
+const FLAG_64 = 1 << 16;
+const FLAG_OBJECT_AS_ID = 1 << 16;
+// Arrays keep their element type in bits 16-17, dictionaries their key type
+// in bits 16-17 and their value type in bits 18-19.
+const ARRAY_TYPED_MASK = 0x3 << 16;
+const DICTIONARY_TYPED_MASK = 0xf << 16;
+
+const enum VariantType {
+  NIL = 0,
+  BOOL,
+  INT,
+  FLOAT,
+  STRING,
+  VECTOR2,
+  VECTOR2I,
+  RECT2,
+  RECT2I,
+  VECTOR3,
+  VECTOR3I,
+  TRANSFORM2D,
+  VECTOR4,
+  VECTOR4I,
+  PLANE,
+  QUATERNION,
+  AABB,
+  BASIS,
+  TRANSFORM3D,
+  PROJECTION,
+  COLOR,
+  STRING_NAME,
+  NODE_PATH,
+  RID,
+  OBJECT,
+  CALLABLE,
+  SIGNAL,
+  DICTIONARY,
+  ARRAY,
+  PACKED_BYTE_ARRAY,
+  PACKED_INT32_ARRAY,
+  PACKED_INT64_ARRAY,
+  PACKED_FLOAT32_ARRAY,
+  PACKED_FLOAT64_ARRAY,
+  PACKED_STRING_ARRAY,
+  PACKED_VECTOR2_ARRAY,
+  PACKED_VECTOR3_ARRAY,
+  PACKED_COLOR_ARRAY,
+  PACKED_VECTOR4_ARRAY,
+}
+
+// Number of real_t / float / int32 components of the fixed size types.
+const REAL_COMPONENTS: { [type: number]: number } = {
+  [VariantType.VECTOR2]: 2,
+  [VariantType.RECT2]: 4,
+  [VariantType.VECTOR3]: 3,
+  [VariantType.TRANSFORM2D]: 6,
+  [VariantType.VECTOR4]: 4,
+  [VariantType.PLANE]: 4,
+  [VariantType.QUATERNION]: 4,
+  [VariantType.AABB]: 6,
+  [VariantType.BASIS]: 9,
+  [VariantType.TRANSFORM3D]: 12,
+  [VariantType.PROJECTION]: 16,
+};
+
+const INT_COMPONENTS: { [type: number]: number } = {
+  [VariantType.VECTOR2I]: 2,
+  [VariantType.RECT2I]: 4,
+  [VariantType.VECTOR3I]: 3,
+  [VariantType.VECTOR4I]: 4,
+};
+
+export interface GodotObjectRef {
+  objectId: number;
+}
+
+export interface GodotSignalRef {
+  objectId: number;
+  signal: string;
+}
+
+export interface GodotRidRef {
+  rid: bigint;
+}
+
+export class GodotDecodeError extends Error {}
+
+export class Reader {
+  view: DataView;
+  bytes: Uint8Array;
+
+  constructor(buffer: ArrayBuffer) {
+    this.view = new DataView(buffer);
+    this.bytes = new Uint8Array(buffer);
+  }
+
+  check(offset: number, size: number) {
+    if (offset + size > this.view.byteLength) {
+      throw new GodotDecodeError("Truncated Variant data");
+    }
+  }
+
+  u32(offset: number): number {
+    this.check(offset, 4);
+    return this.view.getUint32(offset, true);
+  }
+
+  // 64 bit integers lose precision above 2^53, like every JS number.
+  i64(offset: number): number {
+    this.check(offset, 8);
+    const lo = this.view.getUint32(offset, true);
+    const hi = this.view.getInt32(offset + 4, true);
+    return hi * 4294967296 + lo;
+  }
+
+  string(offset: number, nullTerminated = false): [string, number] {
+    const len = this.u32(offset);
+    this.check(offset + 4, len);
+    const end = offset + 4 + len;
+    let strEnd = end;
+    if (nullTerminated && len > 0 && this.bytes[strEnd - 1] === 0) {
+      strEnd--;
+    }
+    return [decodeUtf8(this.bytes, offset + 4, strEnd), pad4(end)];
+  }
+}
+
+function pad4(offset: number): number {
+  return (offset + 3) & ~3;
+}
+
+function decodeUtf8(bytes: Uint8Array, start: number, end: number): string {
+  let ascii = true;
+  for (let i = start; i < end; i++) {
+    if (bytes[i]! >= 0x80) {
+      ascii = false;
+      break;
+    }
+  }
+  if (ascii) {
+    let s = "";
+    for (let i = start; i < end; i += 4096) {
+      s += String.fromCharCode.apply(
+        null,
+        Array.from(bytes.subarray(i, Math.min(i + 4096, end)))
+      );
+    }
+    return s;
+  }
+  let s = "";
+  let i = start;
+  while (i < end) {
+    const c = bytes[i++]!;
+    let cp: number;
+    if (c < 0x80) {
+      cp = c;
+    } else if (c < 0xe0) {
+      cp = ((c & 0x1f) << 6) | (bytes[i++]! & 0x3f);
+    } else if (c < 0xf0) {
+      cp = ((c & 0x0f) << 12) | ((bytes[i++]! & 0x3f) << 6) | (bytes[i++]! & 0x3f);
+    } else {
+      cp =
+        ((c & 0x07) << 18) |
+        ((bytes[i++]! & 0x3f) << 12) |
+        ((bytes[i++]! & 0x3f) << 6) |
+        (bytes[i++]! & 0x3f);
+    }
+    s += String.fromCodePoint(cp);
+  }
+  return s;
+}
+
+function checkObjectAsId(header: number) {
+  if (!(header & FLAG_OBJECT_AS_ID)) {
+    throw new GodotDecodeError("Full objects are not supported");
+  }
+}
+
+// Typed containers carry their element types first, these are not supported.
+function checkUntyped(header: number) {
+  const type = header & 0xff;
+  if (type === VariantType.DICTIONARY && header & DICTIONARY_TYPED_MASK) {
+    throw new GodotDecodeError("Typed dictionaries are not supported");
+  }
+  if (type === VariantType.ARRAY && header & ARRAY_TYPED_MASK) {
+    throw new GodotDecodeError("Typed arrays are not supported");
+  }
+}
+
+// Returns the offset after the Variant at offset, without decoding it.
+function skip(r: Reader, offset: number): number {
+  const header = r.u32(offset);
+  const type = header & 0xff;
+  const is64 = (header & FLAG_64) !== 0;
+  let p = offset + 4;
+  if (type in REAL_COMPONENTS) {
+    return p + REAL_COMPONENTS[type]! * (is64 ? 8 : 4);
+  }
+  if (type in INT_COMPONENTS) {
+    return p + INT_COMPONENTS[type]! * 4;
+  }
+  switch (type) {
+    case VariantType.NIL:
+    case VariantType.CALLABLE:
+      return p;
+    case VariantType.SIGNAL:
+      return r.string(p)[1] + 8;
+    case VariantType.BOOL:
+      return p + 4;
+    case VariantType.INT:
+    case VariantType.FLOAT:
+      return p + (is64 ? 8 : 4);
+    case VariantType.STRING:
+    case VariantType.STRING_NAME:
+      return r.string(p)[1];
+    case VariantType.COLOR:
+      return p + 16;
+    case VariantType.NODE_PATH: {
+      const names = r.u32(p) & 0x7fffffff;
+      const subnames = r.u32(p + 4);
+      p += 12;
+      for (let i = 0; i < names + subnames; i++) {
+        p = pad4(p + 4 + r.u32(p));
+      }
+      return p;
+    }
+    case VariantType.RID:
+      return p + 8;
+    case VariantType.OBJECT:
+      checkObjectAsId(header);
+      return p + 8;
+    case VariantType.DICTIONARY: {
+      checkUntyped(header);
+      const count = r.u32(p) & 0x7fffffff;
+      p += 4;
+      for (let i = 0; i < count * 2; i++) {
+        p = skip(r, p);
+      }
+      return p;
+    }
+    case VariantType.ARRAY: {
+      checkUntyped(header);
+      const count = r.u32(p) & 0x7fffffff;
+      p += 4;
+      for (let i = 0; i < count; i++) {
+        p = skip(r, p);
+      }
+      return p;
+    }
+    case VariantType.PACKED_BYTE_ARRAY:
+      return pad4(p + 4 + r.u32(p));
+    case VariantType.PACKED_INT32_ARRAY:
+    case VariantType.PACKED_FLOAT32_ARRAY:
+      return p + 4 + r.u32(p) * 4;
+    case VariantType.PACKED_INT64_ARRAY:
+    case VariantType.PACKED_FLOAT64_ARRAY:
+      return p + 4 + r.u32(p) * 8;
+    case VariantType.PACKED_STRING_ARRAY: {
+      const count = r.u32(p);
+      p += 4;
+      for (let i = 0; i < count; i++) {
+        p = pad4(p + 4 + r.u32(p));
+      }
+      return p;
+    }
+    case VariantType.PACKED_VECTOR2_ARRAY:
+      return p + 4 + r.u32(p) * 2 * (is64 ? 8 : 4);
+    case VariantType.PACKED_VECTOR3_ARRAY:
+      return p + 4 + r.u32(p) * 3 * (is64 ? 8 : 4);
+    case VariantType.PACKED_COLOR_ARRAY:
+      return p + 4 + r.u32(p) * 16;
+    case VariantType.PACKED_VECTOR4_ARRAY:
+      return p + 4 + r.u32(p) * 4 * (is64 ? 8 : 4);
+  }
+  throw new GodotDecodeError("Unsupported Variant type: " + type);
+}
+
+function reals(r: Reader, offset: number, count: number, is64: boolean): number[] {
+  r.check(offset, count * (is64 ? 8 : 4));
+  const out = new Array<number>(count);
+  for (let i = 0; i < count; i++) {
+    out[i] = is64
+      ? r.view.getFloat64(offset + i * 8, true)
+      : r.view.getFloat32(offset + i * 4, true);
+  }
+  return out;
+}
+
+function ints(r: Reader, offset: number, count: number): number[] {
+  r.check(offset, count * 4);
+  const out = new Array<number>(count);
+  for (let i = 0; i < count; i++) {
+    out[i] = r.view.getInt32(offset + i * 4, true);
+  }
+  return out;
+}
+
+function mathValue(type: number, v: number[]): any {
+  switch (type) {
+    case VariantType.VECTOR2:
+    case VariantType.VECTOR2I:
+      return { x: v[0], y: v[1] };
+    case VariantType.RECT2:
+    case VariantType.RECT2I:
+      return { position: { x: v[0], y: v[1] }, size: { x: v[2], y: v[3] } };
+    case VariantType.VECTOR3:
+    case VariantType.VECTOR3I:
+      return { x: v[0], y: v[1], z: v[2] };
+    case VariantType.VECTOR4:
+    case VariantType.VECTOR4I:
+    case VariantType.QUATERNION:
+      return { x: v[0], y: v[1], z: v[2], w: v[3] };
+    case VariantType.PLANE:
+      return { normal: { x: v[0], y: v[1], z: v[2] }, d: v[3] };
+    case VariantType.AABB:
+      return {
+        position: { x: v[0], y: v[1], z: v[2] },
+        size: { x: v[3], y: v[4], z: v[5] },
+      };
+    default:
+      // Transforms, Basis and Projection: the components in Godot's order.
+      return v;
+  }
+}
+
+// Array that decodes its elements on first access.
+export class GodotLazyArray {
+  private _reader: Reader;
+  private _offsets: number[] | null = null;
+  private _cache: Map<number, any> = new Map();
+  private _start: number;
+  readonly length: number;
+
+  constructor(reader: Reader, offset: number) {
+    this._reader = reader;
+    this.length = reader.u32(offset) & 0x7fffffff;
+    this._start = offset + 4;
+  }
+
+  private offsets(): number[] {
+    if (!this._offsets) {
+      const offsets = new Array<number>(this.length);
+      let p = this._start;
+      for (let i = 0; i < this.length; i++) {
+        offsets[i] = p;
+        p = skip(this._reader, p);
+      }
+      this._offsets = offsets;
+    }
+    return this._offsets;
+  }
+
+  get(index: number): any {
+    if (index < 0 || index >= this.length) {
+      return undefined;
+    }
+    if (!this._cache.has(index)) {
+      this._cache.set(index, decodeAt(this._reader, this.offsets()[index]!));
+    }
+    return this._cache.get(index);
+  }
+
+  toArray(): any[] {
+    const out = new Array(this.length);
+    for (let i = 0; i < this.length; i++) {
+      out[i] = materialize(this.get(i));
+    }
+    return out;
+  }
+}
+
+// Dictionary that decodes keys on first access, and values when they are read.
+export class GodotLazyDictionary {
+  private _reader: Reader;
+  private _start: number;
+  private _entries: Map<any, number> | null = null;
+  private _cache: Map<any, any> = new Map();
+  readonly size: number;
+
+  constructor(reader: Reader, offset: number) {
+    this._reader = reader;
+    this.size = reader.u32(offset) & 0x7fffffff;
+    this._start = offset + 4;
+  }
+
+  private entries(): Map<any, number> {
+    if (!this._entries) {
+      const entries = new Map<any, number>();
+      let p = this._start;
+      for (let i = 0; i < this.size; i++) {
+        const key = decodeAt(this._reader, p);
+        p = skip(this._reader, p);
+        entries.set(key, p);
+        p = skip(this._reader, p);
+      }
+      this._entries = entries;
+    }
+    return this._entries;
+  }
+
+  has(key: any): boolean {
+    return this.entries().has(key);
+  }
+
+  get(key: any): any {
+    const offset = this.entries().get(key);
+    if (offset === undefined) {
+      return undefined;
+    }
+    if (!this._cache.has(key)) {
+      this._cache.set(key, decodeAt(this._reader, offset));
+    }
+    return this._cache.get(key);
+  }
+
+  keys(): any[] {
+    return Array.from(this.entries().keys());
+  }
+
+  toObject(): { [key: string]: any } {
+    const out: { [key: string]: any } = {};
+    for (const key of this.keys()) {
+      out[String(key)] = materialize(this.get(key));
+    }
+    return out;
+  }
+}
+
+function materialize(value: any): any {
+  if (value instanceof GodotLazyArray) {
+    return value.toArray();
+  }
+  if (value instanceof GodotLazyDictionary) {
+    return value.toObject();
+  }
+  return value;
+}
+
+function decodeAt(r: Reader, offset: number): any {
+  const header = r.u32(offset);
+  const type = header & 0xff;
+  const is64 = (header & FLAG_64) !== 0;
+  const p = offset + 4;
+  if (type in REAL_COMPONENTS) {
+    return mathValue(type, reals(r, p, REAL_COMPONENTS[type]!, is64));
+  }
+  if (type in INT_COMPONENTS) {
+    return mathValue(type, ints(r, p, INT_COMPONENTS[type]!));
+  }
+  switch (type) {
+    case VariantType.NIL:
+    case VariantType.CALLABLE:
+      // Callables are written without data.
+      return null;
+    case VariantType.SIGNAL: {
+      const [signal, next] = r.string(p);
+      const ref: GodotSignalRef = { objectId: r.i64(next), signal };
+      return ref;
+    }
+    case VariantType.RID: {
+      // RIDs are kept exact, their ids often use all 64 bits.
+      r.check(p, 8);
+      const ref: GodotRidRef = { rid: r.view.getBigUint64(p, true) };
+      return ref;
+    }
+    case VariantType.BOOL:
+      return r.u32(p) !== 0;
+    case VariantType.INT:
+      r.check(p, 4);
+      return is64 ? r.i64(p) : r.view.getInt32(p, true);
+    case VariantType.FLOAT:
+      r.check(p, is64 ? 8 : 4);
+      return is64 ? r.view.getFloat64(p, true) : r.view.getFloat32(p, true);
+    case VariantType.STRING:
+    case VariantType.STRING_NAME:
+      return r.string(p)[0];
+    case VariantType.COLOR: {
+      const c = reals(r, p, 4, false);
+      return { r: c[0], g: c[1], b: c[2], a: c[3] };
+    }
+    case VariantType.NODE_PATH: {
+      const names = r.u32(p) & 0x7fffffff;
+      const subnames = r.u32(p + 4);
+      const absolute = (r.u32(p + 8) & 1) !== 0;
+      let q = p + 12;
+      const parts: string[] = [];
+      for (let i = 0; i < names + subnames; i++) {
+        const [s, next] = r.string(q);
+        parts.push(s);
+        q = next;
+      }
+      let path = (absolute ? "/" : "") + parts.slice(0, names).join("/");
+      for (const sub of parts.slice(names)) {
+        path += ":" + sub;
+      }
+      return path;
+    }
+    case VariantType.OBJECT: {
+      // Id 0 is a null object, like in bytes_to_var().
+      checkObjectAsId(header);
+      const objectId = r.i64(p);
+      if (objectId === 0) {
+        return null;
+      }
+      const ref: GodotObjectRef = { objectId };
+      return ref;
+    }
+    case VariantType.DICTIONARY:
+      checkUntyped(header);
+      return new GodotLazyDictionary(r, p);
+    case VariantType.ARRAY:
+      checkUntyped(header);
+      return new GodotLazyArray(r, p);
+    case VariantType.PACKED_BYTE_ARRAY: {
+      const len = r.u32(p);
+      r.check(p + 4, len);
+      return r.bytes.slice(p + 4, p + 4 + len);
+    }
+    case VariantType.PACKED_INT32_ARRAY: {
+      const count = r.u32(p);
+      return Int32Array.from(ints(r, p + 4, count));
+    }
+    case VariantType.PACKED_INT64_ARRAY: {
+      const count = r.u32(p);
+      r.check(p + 4, count * 8);
+      const out = new Float64Array(count);
+      for (let i = 0; i < count; i++) {
+        out[i] = r.i64(p + 4 + i * 8);
+      }
+      return out;
+    }
+    case VariantType.PACKED_FLOAT32_ARRAY: {
+      const count = r.u32(p);
+      return Float32Array.from(reals(r, p + 4, count, false));
+    }
+    case VariantType.PACKED_FLOAT64_ARRAY: {
+      const count = r.u32(p);
+      return Float64Array.from(reals(r, p + 4, count, true));
+    }
+    case VariantType.PACKED_STRING_ARRAY: {
+      const count = r.u32(p);
+      const out = new Array<string>(count);
+      let q = p + 4;
+      for (let i = 0; i < count; i++) {
+        const [s, next] = r.string(q, true);
+        out[i] = s;
+        q = next;
+      }
+      return out;
+    }
+    case VariantType.PACKED_VECTOR2_ARRAY:
+    case VariantType.PACKED_VECTOR3_ARRAY:
+    case VariantType.PACKED_COLOR_ARRAY:
+    case VariantType.PACKED_VECTOR4_ARRAY: {
+      // Flat component arrays, e.g. [x0, y0, x1, y1, ...] for PackedVector2Array.
+      const count = r.u32(p);
+      const components =
+        type === VariantType.PACKED_VECTOR2_ARRAY
+          ? 2
+          : type === VariantType.PACKED_VECTOR3_ARRAY
+          ? 3
+          : 4;
+      const wide = is64 && type !== VariantType.PACKED_COLOR_ARRAY;
+      const values = reals(r, p + 4, count * components, wide);
+      return wide ? Float64Array.from(values) : Float32Array.from(values);
+    }
+  }
+  throw new GodotDecodeError("Unsupported Variant type: " + type);
+}
+
+// Decodes the Variant at offset. Arrays and dictionaries are returned as
+// GodotLazyArray / GodotLazyDictionary, use decodeVariantDeep() to get
+// plain JS values.
+export function decodeVariant(buffer: ArrayBuffer, offset = 0): any {
+  return decodeAt(new Reader(buffer), offset);
+}
+
+export function decodeVariantDeep(buffer: ArrayBuffer, offset = 0): any {
+  return materialize(decodeVariant(buffer, offset));
+}
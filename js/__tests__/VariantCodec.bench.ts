@@ -0,0 +1,122 @@
+/**************************************************************************/
+/*  VariantCodec.bench.ts                                                 */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+// Benchmark of the JS side of the Variant codec on a large nested
+// dictionary, run with `yarn bench:codec`. decodeVariantDeep() converts
+// every field up front, like the per-field conversion of
+// godotVariantToJsiValue() does. The lazy decoder only decodes the fields
+// that are read. The native per-field path itself needs the engine and a
+// JSI runtime, compare it in the app with the fromVariant metric of
+// RTNGodot.getBridgeStats().
+
+import { decodeVariant, decodeVariantDeep } from "../VariantCodec";
+
+const INT = 2;
+const STRING = 4;
+const VECTOR2 = 5;
+const DICTIONARY = 27;
+const ARRAY = 28;
+
+class Encoder {
+  bytes: number[] = [];
+
+  u32(value: number) {
+    this.bytes.push(value & 0xff, (value >>> 8) & 0xff, (value >>> 16) & 0xff, value >>> 24);
+  }
+
+  f32(value: number) {
+    this.bytes.push(...new Uint8Array(new Float32Array([value]).buffer));
+  }
+
+  str(value: string) {
+    const utf8 = new TextEncoder().encode(value);
+    this.u32(STRING);
+    this.u32(utf8.length);
+    this.bytes.push(...utf8);
+    while (this.bytes.length % 4) {
+      this.bytes.push(0);
+    }
+  }
+
+  int(value: number) {
+    this.u32(INT);
+    this.u32(value);
+  }
+}
+
+// { "entity_<i>": { name, hp, position: Vector2, tags: [int x 4] } }
+function encodeLevel(entities: number): ArrayBuffer {
+  const e = new Encoder();
+  e.u32(DICTIONARY);
+  e.u32(entities);
+  for (let i = 0; i < entities; i++) {
+    e.str("entity_" + i);
+    e.u32(DICTIONARY);
+    e.u32(4);
+    e.str("name");
+    e.str("Entity " + i);
+    e.str("hp");
+    e.int(100 + i);
+    e.str("position");
+    e.u32(VECTOR2);
+    e.f32(i);
+    e.f32(-i);
+    e.str("tags");
+    e.u32(ARRAY);
+    e.u32(4);
+    for (let t = 0; t < 4; t++) {
+      e.int(i * 4 + t);
+    }
+  }
+  return new Uint8Array(e.bytes).buffer;
+}
+
+function measure(name: string, iterations: number, op: () => void) {
+  for (let i = 0; i < iterations / 10; i++) {
+    op();
+  }
+  const start = performance.now();
+  for (let i = 0; i < iterations; i++) {
+    op();
+  }
+  const usPerOp = ((performance.now() - start) * 1000) / iterations;
+  console.log(`${name}: ${usPerOp.toFixed(1)} us/op`);
+}
+
+describe("VariantCodec", () => {
+  it("decodes a large nested dictionary", () => {
+    const buffer = encodeLevel(2000);
+    measure("decodeVariantDeep, 2000 entities", 50, () => {
+      decodeVariantDeep(buffer);
+    });
+    measure("decodeVariant, read 10 entities", 50, () => {
+      const level = decodeVariant(buffer);
+      for (let i = 0; i < 2000; i += 200) {
+        level.get("entity_" + i).get("hp");
+      }
+    });
+    expect(decodeVariantDeep(buffer).entity_1999.hp).toBe(2099);
+  });
+});
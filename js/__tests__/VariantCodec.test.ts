@@ -0,0 +1,199 @@
+/**************************************************************************/
+/*  VariantCodec.test.ts                                                  */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+// The fixtures are the bytes var_to_bytes() writes for each value, following
+// encode_variant() in core/io/marshalls.cpp of Godot 4.5. Values are little
+// endian, strings are UTF-8 padded to 4 bytes.
+
+import {
+  decodeVariant,
+  decodeVariantDeep,
+  GodotDecodeError,
+  GodotLazyArray,
+  GodotLazyDictionary,
+} from "../VariantCodec";
+
+function bytes(...parts: number[][]): ArrayBuffer {
+  return new Uint8Array(parts.flat()).buffer;
+}
+
+function u32(value: number): number[] {
+  return [value & 0xff, (value >>> 8) & 0xff, (value >>> 16) & 0xff, value >>> 24];
+}
+
+function u64(value: number): number[] {
+  return [...u32(value >>> 0), ...u32(Math.floor(value / 4294967296))];
+}
+
+function f32(value: number): number[] {
+  return Array.from(new Uint8Array(new Float32Array([value]).buffer));
+}
+
+function f64(value: number): number[] {
+  return Array.from(new Uint8Array(new Float64Array([value]).buffer));
+}
+
+function str(value: string): number[] {
+  const utf8 = Array.from(new TextEncoder().encode(value));
+  const padding = (4 - (utf8.length % 4)) % 4;
+  return [...u32(utf8.length), ...utf8, ...new Array(padding).fill(0)];
+}
+
+const NIL = 0;
+const BOOL = 1;
+const INT = 2;
+const FLOAT = 3;
+const STRING = 4;
+const VECTOR2 = 5;
+const RID = 23;
+const OBJECT = 24;
+const CALLABLE = 25;
+const SIGNAL = 26;
+const DICTIONARY = 27;
+const ARRAY = 28;
+const PACKED_INT32_ARRAY = 30;
+const PACKED_STRING_ARRAY = 34;
+
+const FLAG_64 = 1 << 16;
+const FLAG_OBJECT_AS_ID = 1 << 16;
+
+describe("decodeVariant", () => {
+  it("decodes scalars", () => {
+    expect(decodeVariant(bytes(u32(NIL)))).toBeNull();
+    expect(decodeVariant(bytes(u32(BOOL), u32(1)))).toBe(true);
+    expect(decodeVariant(bytes(u32(INT), u32(42)))).toBe(42);
+    expect(decodeVariant(bytes(u32(INT), u32(-7 >>> 0)))).toBe(-7);
+    expect(decodeVariant(bytes(u32(INT | FLAG_64), u64(2 ** 40)))).toBe(2 ** 40);
+    // Floats that fit in 32 bits are written without the 64 bit flag.
+    expect(decodeVariant(bytes(u32(FLOAT), f32(1.5)))).toBe(1.5);
+    expect(decodeVariant(bytes(u32(FLOAT | FLAG_64), f64(0.1)))).toBe(0.1);
+  });
+
+  it("decodes strings", () => {
+    expect(decodeVariant(bytes(u32(STRING), str("")))).toBe("");
+    expect(decodeVariant(bytes(u32(STRING), str("abc")))).toBe("abc");
+    expect(decodeVariant(bytes(u32(STRING), str("héllo wörld")))).toBe("héllo wörld");
+    expect(decodeVariant(bytes(u32(STRING), str("日本語 🎮")))).toBe("日本語 🎮");
+  });
+
+  it("decodes math types", () => {
+    expect(decodeVariant(bytes(u32(VECTOR2), f32(1), f32(2)))).toEqual({ x: 1, y: 2 });
+    expect(decodeVariant(bytes(u32(VECTOR2 | FLAG_64), f64(0.1), f64(0.2)))).toEqual({
+      x: 0.1,
+      y: 0.2,
+    });
+  });
+
+  it("decodes objects encoded as ids", () => {
+    expect(decodeVariant(bytes(u32(OBJECT | FLAG_OBJECT_AS_ID), u64(1234)))).toEqual({
+      objectId: 1234,
+    });
+    expect(decodeVariant(bytes(u32(OBJECT | FLAG_OBJECT_AS_ID), u64(0)))).toBeNull();
+    expect(() => decodeVariant(bytes(u32(OBJECT), u32(0)))).toThrow(GodotDecodeError);
+  });
+
+  it("decodes signals, RIDs and callables", () => {
+    expect(decodeVariant(bytes(u32(SIGNAL), str("pressed"), u64(1234)))).toEqual({
+      objectId: 1234,
+      signal: "pressed",
+    });
+    // RID ids use the upper 32 bits for a validator.
+    expect(decodeVariant(bytes(u32(RID), u32(7), u32(0x80000001)))).toEqual({
+      rid: (0x80000001n << 32n) | 7n,
+    });
+    expect(decodeVariant(bytes(u32(CALLABLE)))).toBeNull();
+
+    // Signals are skipped with their name and id.
+    const array = bytes(
+      u32(ARRAY),
+      u32(2),
+      [...u32(SIGNAL), ...str("hit"), ...u64(5)],
+      [...u32(INT), ...u32(9)]
+    );
+    expect(decodeVariant(array).get(1)).toBe(9);
+  });
+
+  it("decodes arrays and dictionaries", () => {
+    const array = bytes(
+      u32(ARRAY),
+      u32(3),
+      [...u32(INT), ...u32(1)],
+      [...u32(STRING), ...str("a")],
+      [...u32(ARRAY), ...u32(1), ...u32(BOOL), ...u32(0)]
+    );
+    expect(decodeVariant(array)).toBeInstanceOf(GodotLazyArray);
+    expect(decodeVariant(array).get(1)).toBe("a");
+    expect(decodeVariantDeep(array)).toEqual([1, "a", [false]]);
+
+    const dictionary = bytes(
+      u32(DICTIONARY),
+      u32(2),
+      [...u32(STRING), ...str("name")],
+      [...u32(STRING), ...str("Godot")],
+      [...u32(STRING), ...str("ids")],
+      [...u32(PACKED_INT32_ARRAY), ...u32(2), ...u32(3), ...u32(4)]
+    );
+    expect(decodeVariant(dictionary)).toBeInstanceOf(GodotLazyDictionary);
+    expect(decodeVariant(dictionary).get("name")).toBe("Godot");
+    expect(decodeVariantDeep(dictionary)).toEqual({
+      name: "Godot",
+      ids: Int32Array.from([3, 4]),
+    });
+  });
+
+  it("decodes packed string arrays", () => {
+    const packed = bytes(u32(PACKED_STRING_ARRAY), u32(2), str("a"), str("ü"));
+    expect(decodeVariant(packed)).toEqual(["a", "ü"]);
+  });
+
+  it("rejects typed arrays and dictionaries", () => {
+    // Array[int]: the element type is in bits 16-17.
+    const typedArray = bytes(u32(ARRAY | (1 << 16)), u32(INT), u32(0));
+    expect(() => decodeVariant(typedArray)).toThrow(GodotDecodeError);
+
+    // Dictionary[Variant, int]: only the value type is set, in bits 18-19.
+    const typedValues = bytes(u32(DICTIONARY | (1 << 18)), u32(INT), u32(0));
+    expect(() => decodeVariant(typedValues)).toThrow(GodotDecodeError);
+
+    // Dictionary[String, Variant]: only the key type is set, in bits 16-17.
+    const typedKeys = bytes(u32(DICTIONARY | (1 << 16)), u32(STRING), u32(0));
+    expect(() => decodeVariant(typedKeys)).toThrow(GodotDecodeError);
+
+    // A typed dictionary inside an untyped array is rejected when the array
+    // is walked, rather than skipped with the wrong size.
+    const nested = bytes(
+      u32(ARRAY),
+      u32(2),
+      [...u32(DICTIONARY | (1 << 18)), ...u32(INT), ...u32(0)],
+      [...u32(INT), ...u32(5)]
+    );
+    expect(() => decodeVariant(nested).get(1)).toThrow(GodotDecodeError);
+  });
+
+  it("rejects truncated data", () => {
+    expect(() => decodeVariant(bytes(u32(INT | FLAG_64), u32(0)))).toThrow(GodotDecodeError);
+    expect(() => decodeVariant(bytes(u32(STRING), u32(8), [0x61]))).toThrow(GodotDecodeError);
+  });
+});
@@ -24,6 +24,47 @@
 /**************************************************************************/
 
 export { RTNGodot, runOnGodotThread } from "./NativeGodotModule";
+export type {
+  GodotEvent,
+  GodotEventStream,
+  GodotEventStreamOptions,
+  GodotEventStreamStats,
+  GodotTaskPriority,
+  GodotTaskStats,
+  GodotThreadConfig,
+  GodotThreadStats,
+  GodotLogLevel,
+  GodotBridgeMetric,
+  GodotBridgeStats,
+  GodotNumberArray,
+  GodotArrayLayout,
+  GodotPreloadHandle,
+  GodotPreloadOptions,
+  GodotPreloadPriority,
+  GodotPreloadStats,
+  GodotShaderCacheStats,
+  GodotWarmUpResult,
+  GodotStartupPhase,
+  GodotStartupReport,
+} from "./NativeGodotModule";
+
+export { readStateChannel, getStateChannelVersion } from "./StateChannel";
+export type {
+  GodotStateChannel,
+  GodotStateField,
+  GodotStateFieldType,
+  GodotStateLayout,
+  GodotStateValues,
+} from "./StateChannel";
+
+export {
+  decodeVariant,
+  decodeVariantDeep,
+  GodotDecodeError,
+  GodotLazyArray,
+  GodotLazyDictionary,
+} from "./VariantCodec";
+export type { GodotObjectRef, GodotRidRef, GodotSignalRef } from "./VariantCodec";
 
 import RTNGodotView from "./RTNGodotViewNativeComponent";
 
@@ -0,0 +1,548 @@
+/**************************************************************************/
+/*  GodotModule.cpp                                                       */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "GodotModule.h"
+#include "WindowRegistry.h"
+#define LOG_TAG "GodotModule"
+#include "godot-log.h"
+
+#include "GodotEventStream.h"
+#include "SceneSnapshot.h"
+#include "StartupTrace.h"
+#include "TaskExecutor.h"
+#include <libgodot/libgodot.h>
+#include <godot_cpp/godot.hpp>
+
+#include <dlfcn.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Headless backend for desktop Linux, e.g. to run exported projects and
+// measure the bridge on build servers without a GPU. Godot runs with the
+// headless display driver and the dummy renderer, frames are driven by a
+// timer on the Godot thread instead of a vsync callback.
+
+typedef GDExtensionObjectPtr (*libgodot_create_godot_instance_type)(int, char *[], GDExtensionInitializationFunction, InvokeCallbackFunction, ExecutorData, InvokeCallbackFunction, ExecutorData, LogCallbackFunction, LogCallbackData);
+typedef void (*libgodot_destroy_godot_instance_type)(GDExtensionObjectPtr p_godot_instance);
+
+// Godot thread that runs the queued tasks and, while frames are enabled,
+// one iteration per frame period.
+class LinuxThread : public TaskExecutor {
+	typedef std::chrono::steady_clock Clock;
+
+	std::mutex _wait_mutex;
+	std::condition_variable _wait_var;
+	bool _woken = false;
+	bool _quit = false;
+	bool _frames = false;
+	Clock::duration _frame_period = std::chrono::nanoseconds(16666667);
+	Clock::time_point _next_frame;
+	std::thread _thread;
+
+	void run() {
+		LOGI("LinuxThread started.");
+		bind_current_thread();
+		while (true) {
+			bool frame = false;
+			{
+				std::unique_lock lock(_wait_mutex);
+				if (_frames) {
+					_wait_var.wait_until(lock, _next_frame, [this]() { return _woken || _quit || !_frames; });
+				} else {
+					_wait_var.wait(lock, [this]() { return _woken || _quit || _frames; });
+				}
+				if (_quit) {
+					break;
+				}
+				_woken = false;
+				Clock::time_point now = Clock::now();
+				if (_frames && now >= _next_frame) {
+					frame = true;
+					_next_frame += _frame_period;
+					if (_next_frame < now) {
+						// Late frames are dropped instead of run back to back.
+						_next_frame = now + _frame_period;
+					}
+				}
+			}
+			run_pending();
+			if (frame) {
+				Clock::time_point deadline;
+				{
+					std::lock_guard lock(_wait_mutex);
+					deadline = _next_frame;
+				}
+				StartupTrace::mark(STARTUP_FIRST_FRAME_CALLBACK);
+				begin_frame(deadline);
+				GodotModule::get_singleton()->iterate();
+				run_idle();
+			}
+		}
+		LOGI("LinuxThread exited.");
+	}
+
+protected:
+	void wake() override {
+		{
+			std::lock_guard lock(_wait_mutex);
+			_woken = true;
+		}
+		_wait_var.notify_one();
+	}
+
+public:
+	LinuxThread() {
+		const char *fps = getenv("RTN_GODOT_FPS");
+		if (fps && atof(fps) > 0) {
+			_frame_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / atof(fps)));
+		}
+		_thread = std::thread(&LinuxThread::run, this);
+	}
+
+	~LinuxThread() {
+		{
+			std::lock_guard lock(_wait_mutex);
+			_quit = true;
+		}
+		_wait_var.notify_one();
+		_thread.join();
+	}
+
+	void set_frames_enabled(bool enabled) {
+		{
+			std::lock_guard lock(_wait_mutex);
+			if (enabled && !_frames) {
+				_next_frame = Clock::now();
+			}
+			_frames = enabled;
+		}
+		_wait_var.notify_one();
+	}
+};
+
+struct LinuxPlatformData : PlatformData {
+	void *handle = nullptr;
+	libgodot_create_godot_instance_type func_libgodot_create_godot_instance = nullptr;
+	libgodot_destroy_godot_instance_type func_libgodot_destroy_godot_instance = nullptr;
+	std::map<std::string, std::function<void(bool)>> windowUpdateCallbacks;
+	std::map<void *, std::string> handleToWindowName;
+	bool in_background = false;
+	bool paused = false;
+	std::mutex windowUpdateMutex;
+	std::mutex createMutex;
+	LinuxThread thread;
+};
+
+GodotModule *GodotModule::get_singleton() {
+	static GodotModule *singleton = new GodotModule(new LinuxPlatformData());
+	return singleton;
+}
+
+extern "C" {
+
+static void initialize_default_module(godot::ModuleInitializationLevel p_level) {
+	if (p_level != godot::MODULE_INITIALIZATION_LEVEL_SCENE) {
+		return;
+	}
+}
+
+static void uninitialize_default_module(godot::ModuleInitializationLevel p_level) {
+	if (p_level != godot::MODULE_INITIALIZATION_LEVEL_SCENE) {
+		return;
+	}
+}
+
+static void logCallBack(LogCallbackData p_data, const char *p_log_message, bool p_err) {
+	GodotModule *gm = (GodotModule *)p_data;
+	gm->log(p_log_message, p_err);
+}
+
+GDExtensionBool GDE_EXPORT gdextension_default_init(GDExtensionInterfaceGetProcAddress p_get_proc_address, GDExtensionClassLibraryPtr p_library, GDExtensionInitialization *r_initialization) {
+	godot::GDExtensionBinding::InitObject init_object(p_get_proc_address, p_library, r_initialization);
+
+	init_object.register_initializer(initialize_default_module);
+	init_object.register_terminator(uninitialize_default_module);
+	init_object.set_minimum_library_initialization_level(godot::MODULE_INITIALIZATION_LEVEL_SCENE);
+
+	return init_object.init();
+}
+}
+
+godot::GodotInstance *GodotModule::get_or_create_instance(std::vector<std::string> args) {
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+
+	// Make sure that we only run this method once at a time.
+	std::lock_guard createLock(data->createMutex);
+
+	{
+		std::lock_guard lock(_mutex);
+		if (_instance) {
+			return _instance;
+		}
+	}
+
+	StartupTrace::begin();
+	// The arguments as requested, before the snapshot scene is added.
+	std::vector<std::string> requested_args = args;
+	SceneSnapshot::apply(args);
+	void *handle = nullptr;
+	if (!data->func_libgodot_create_godot_instance) {
+		// RTN_GODOT_LIBRARY overrides the library found on the library path.
+		const char *path = getenv("RTN_GODOT_LIBRARY");
+		handle = dlopen(path ? path : "libgodot.so", RTLD_LAZY | RTLD_LOCAL);
+		if (handle == nullptr) {
+			LOGE("Unable to open libgodot.so: %s", dlerror());
+			return nullptr;
+		}
+		libgodot_create_godot_instance_type func_libgodot_create_godot_instance = (libgodot_create_godot_instance_type)dlsym(handle, "libgodot_create_godot_instance");
+		if (func_libgodot_create_godot_instance == nullptr) {
+			LOGE("Unable to load libgodot_create_godot_instance symbol: %s", dlerror());
+			dlclose(handle);
+			return nullptr;
+		}
+		{
+			std::lock_guard lock(_mutex);
+			data->func_libgodot_create_godot_instance = func_libgodot_create_godot_instance;
+		}
+	}
+
+	StartupTrace::mark(STARTUP_LIBRARY_LOADED);
+
+	// No display or GPU, arguments passed by the app come last and can override these.
+	std::vector<std::string> cmdline{ "godot", "--headless", "--display-driver", "headless", "--rendering-driver", "dummy", "--audio-driver", "Dummy" };
+	for (const std::string &arg : args) {
+		cmdline.push_back(arg);
+	}
+
+	std::vector<const char *> cargs{};
+	for (const std::string &arg : cmdline) {
+		cargs.push_back(arg.c_str());
+	}
+
+	GDExtensionObjectPtr instance_ptr = data->func_libgodot_create_godot_instance(cargs.size(), (char **)cargs.data(), gdextension_default_init, nullptr, nullptr, nullptr, nullptr, logCallBack, this);
+	if (instance_ptr == nullptr) {
+		LOGE("Unable to start Godot");
+		if (handle) {
+			dlclose(handle);
+			std::lock_guard lock(_mutex);
+			data->func_libgodot_create_godot_instance = nullptr;
+		}
+		return nullptr;
+	}
+
+	godot::GodotInstance *instance = reinterpret_cast<godot::GodotInstance *>(godot::internal::get_object_instance_binding(instance_ptr));
+	StartupTrace::mark(STARTUP_INSTANCE_CREATED);
+	if (instance->start()) {
+		StartupTrace::mark(STARTUP_INSTANCE_STARTED);
+	}
+
+	{
+		std::lock_guard lock(_mutex);
+		if (handle) {
+			data->handle = handle;
+		}
+		_instance = instance;
+		_instance_args = requested_args;
+		updateState();
+	}
+
+	updateWindows(true);
+
+	return instance;
+}
+
+double GodotModule::get_content_scale_factor() {
+	return 1.0;
+}
+
+void GodotModule::destroy_instance() {
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+
+	// Make sure that we only run this method once at a time.
+	std::lock_guard createLock(data->createMutex);
+
+	if (!_instance) {
+		LOGI("Godot instance is already destroyed.");
+		return;
+	}
+
+	// A snapshot save started on pause still calls into Godot.
+	SceneSnapshot::wait_for_saves();
+
+	if (!data->func_libgodot_destroy_godot_instance) {
+		libgodot_destroy_godot_instance_type func_libgodot_destroy_godot_instance = (libgodot_destroy_godot_instance_type)dlsym(data->handle, "libgodot_destroy_godot_instance");
+		if (func_libgodot_destroy_godot_instance == nullptr) {
+			LOGE("Unable to load libgodot_destroy_godot_instance symbol: %s", dlerror());
+			return;
+		}
+		std::lock_guard lock(_mutex);
+		data->func_libgodot_destroy_godot_instance = func_libgodot_destroy_godot_instance;
+	}
+
+	data->thread.set_frames_enabled(false);
+	updateWindows(false);
+
+	// iterate() runs on the Godot thread without holding _mutex, so the
+	// instance is destroyed there, between two iterations.
+	auto destroy = [this, data]() {
+		std::lock_guard lock(_mutex);
+
+		GodotEventStream::close_all();
+		data->func_libgodot_destroy_godot_instance(_instance->_owner);
+		_instance = nullptr;
+		_instance_args.clear();
+		WindowRegistry::get_singleton()->reset();
+		godot::GDExtensionBinding::deinit();
+
+		dlclose(data->handle);
+		data->handle = nullptr;
+		data->func_libgodot_create_godot_instance = nullptr;
+		data->func_libgodot_destroy_godot_instance = nullptr;
+
+		data->paused = false;
+	};
+	data->thread.run_sync(destroy);
+}
+
+godot::Ref<godot::RenderingNativeSurface> GodotModule::get_main_rendering_surface() {
+	// The headless display server renders nothing.
+	return godot::Ref<godot::RenderingNativeSurface>(nullptr);
+}
+
+void *GodotModule::get_main_rendering_layer() {
+	return nullptr;
+}
+
+void GodotModule::focus_out() {
+	std::lock_guard lock(_mutex);
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	data->in_background = true;
+	data->thread.post([this]() {
+		std::lock_guard lock(_mutex);
+		if (_instance) {
+			_instance->focus_out();
+		}
+	},
+			TASK_PRIORITY_URGENT);
+	updateState();
+}
+
+void GodotModule::focus_in() {
+	std::lock_guard lock(_mutex);
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	data->in_background = false;
+	data->thread.post([this]() {
+		std::lock_guard lock(_mutex);
+		if (_instance) {
+			_instance->focus_in();
+		}
+	},
+			TASK_PRIORITY_URGENT);
+	updateState();
+}
+
+bool GodotModule::is_paused() {
+	std::lock_guard lock(_mutex);
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	return data->paused;
+}
+
+void GodotModule::appPause() {
+	std::lock_guard lock(_mutex);
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	data->in_background = true;
+	data->thread.post([this]() {
+		std::lock_guard lock(_mutex);
+		if (_instance) {
+			SceneSnapshot::capture();
+			_instance->pause();
+		}
+	},
+			TASK_PRIORITY_URGENT);
+	updateState();
+}
+
+void GodotModule::appResume() {
+	std::lock_guard lock(_mutex);
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	data->in_background = false;
+	data->thread.post([this]() {
+		std::lock_guard lock(_mutex);
+		if (_instance) {
+			_instance->resume();
+		}
+	},
+			TASK_PRIORITY_URGENT);
+	updateState();
+}
+
+void GodotModule::pause() {
+	std::lock_guard lock(_mutex);
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	data->paused = true;
+	updateState();
+}
+
+void GodotModule::resume() {
+	std::lock_guard lock(_mutex);
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	data->paused = false;
+	updateState();
+}
+
+void GodotModule::updateState() {
+	// Called with _mutex held.
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	bool running = _instance && !data->in_background && !data->paused;
+	data->thread.set_frames_enabled(running);
+	if (!running) {
+		// Without frames the background lane must not wait for a deadline.
+		data->thread.end_frames();
+	}
+}
+
+class CPPCallable : public godot::CallableCustom {
+	std::function<void(const godot::Variant **, int, godot::Variant &, GDExtensionCallError &)> _func;
+
+public:
+	CPPCallable(std::function<void(const godot::Variant **, int, godot::Variant &, GDExtensionCallError &)> f) :
+			_func(f) {}
+
+	uint32_t hash() const override {
+		return 0; // Use default hash function
+	}
+	godot::String get_as_text() const override {
+		return godot::String("CPPCallable");
+	}
+	CompareEqualFunc get_compare_equal_func() const override {
+		return nullptr;
+	}
+
+	CompareLessFunc get_compare_less_func() const override {
+		return nullptr;
+	}
+
+	bool is_valid() const override {
+		return true;
+	}
+	godot::ObjectID get_object() const override {
+		return godot::ObjectID();
+	}
+	void call(const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) const override {
+		_func(p_arguments, p_argcount, r_return_value, r_call_error);
+		r_call_error.error = GDEXTENSION_CALL_OK;
+	}
+};
+
+godot::Callable GodotModule::create_callable(std::function<void(const godot::Variant **, int, godot::Variant &, GDExtensionCallError &)> f) {
+	return godot::Callable(memnew(CPPCallable(f)));
+}
+
+// There are no native views on Linux, callbacks registered by a host app
+// are still called so it can follow the instance lifecycle.
+void GodotModule::registerWindowUpdateCallback(std::string name, void *handle, std::function<void(bool)> f, void *ref) {
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	std::lock_guard lock(data->windowUpdateMutex);
+	LOGD("Registering Window: %llx, %s", (unsigned long long)handle, name.c_str());
+	if (data->handleToWindowName.contains(handle)) {
+		std::string currentName = data->handleToWindowName[handle];
+		if (currentName != name) {
+			LOGE("RegisterWindowUpdateCallback: Unable to register a different name for the same handle");
+			return;
+		}
+	} else {
+		data->handleToWindowName[handle] = name;
+	}
+	data->windowUpdateCallbacks[name] = f;
+}
+
+void GodotModule::unregisterWindowUpdateCallback(void *handle) {
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	std::lock_guard lock(data->windowUpdateMutex);
+	if (data->handleToWindowName.contains(handle)) {
+		std::string name = data->handleToWindowName[handle];
+		LOGD("Unregistering Window: %llx, %s", (unsigned long long)handle, name.c_str());
+		data->windowUpdateCallbacks.erase(name);
+		data->handleToWindowName.erase(handle);
+	}
+}
+
+void GodotModule::updateWindow(std::string name, bool adding) {
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	std::function<void(bool)> cb;
+	{
+		std::lock_guard lock(data->windowUpdateMutex);
+		if (!data->windowUpdateCallbacks.contains(name)) {
+			return;
+		}
+		cb = data->windowUpdateCallbacks[name];
+	}
+	cb(adding);
+}
+
+void GodotModule::updateWindows(bool adding) {
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	std::map<std::string, std::function<void(bool)>> callbacks;
+	{
+		std::lock_guard lock(data->windowUpdateMutex);
+		callbacks = data->windowUpdateCallbacks;
+	}
+	for (const std::pair<std::string, std::function<void(bool)>> elem : callbacks) {
+		LOGD("Updating Window: %s", elem.first.c_str());
+		elem.second(adding);
+	}
+}
+
+void GodotModule::runOnGodotThread(std::function<void()> f, bool wait, TaskPriority priority) {
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	if (wait) {
+		data->thread.run_sync(f, priority);
+	} else {
+		data->thread.enqueue(std::move(f), priority);
+	}
+}
+
+TaskExecutor *GodotModule::get_thread() {
+	LinuxPlatformData *data = static_cast<LinuxPlatformData *>(_data);
+	return &data->thread;
+}
+
+void GodotModule::iterate() {
+	godot::GodotInstance *instance = nullptr;
+	{
+		std::lock_guard lock(_mutex);
+		instance = _instance;
+	}
+	if (instance && instance->is_started()) {
+		instance->iteration();
+		StartupTrace::mark(STARTUP_FIRST_ITERATION);
+	}
+}
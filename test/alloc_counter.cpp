@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*  alloc_counter.cpp                                                     */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> allocation_count = 0;
+
+uint64_t get_allocation_count() {
+	return allocation_count.load(std::memory_order_relaxed);
+}
+
+static void *counted_alloc(size_t p_size, size_t p_align) {
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	if (p_size == 0) {
+		p_size = 1;
+	}
+	void *ptr = nullptr;
+	if (p_align <= alignof(std::max_align_t)) {
+		ptr = malloc(p_size);
+	} else {
+		ptr = aligned_alloc(p_align, (p_size + p_align - 1) / p_align * p_align);
+	}
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void *operator new(size_t p_size) {
+	return counted_alloc(p_size, alignof(std::max_align_t));
+}
+
+void *operator new[](size_t p_size) {
+	return counted_alloc(p_size, alignof(std::max_align_t));
+}
+
+void *operator new(size_t p_size, std::align_val_t p_align) {
+	return counted_alloc(p_size, (size_t)p_align);
+}
+
+void *operator new[](size_t p_size, std::align_val_t p_align) {
+	return counted_alloc(p_size, (size_t)p_align);
+}
+
+void operator delete(void *p_ptr) noexcept {
+	free(p_ptr);
+}
+
+void operator delete[](void *p_ptr) noexcept {
+	free(p_ptr);
+}
+
+void operator delete(void *p_ptr, size_t) noexcept {
+	free(p_ptr);
+}
+
+void operator delete[](void *p_ptr, size_t) noexcept {
+	free(p_ptr);
+}
+
+void operator delete(void *p_ptr, std::align_val_t) noexcept {
+	free(p_ptr);
+}
+
+void operator delete[](void *p_ptr, std::align_val_t) noexcept {
+	free(p_ptr);
+}
+
+void operator delete(void *p_ptr, size_t, std::align_val_t) noexcept {
+	free(p_ptr);
+}
+
+void operator delete[](void *p_ptr, size_t, std::align_val_t) noexcept {
+	free(p_ptr);
+}
@@ -0,0 +1,234 @@
+/**************************************************************************/
+/*  bench_bridge.cpp                                                      */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+// Micro benchmarks of the host buildable bridge paths. Prints one JSON
+// object to stdout, so runs can be stored and compared:
+//   build/test/bench_bridge > bench.json
+//
+// Only the parts of the bridge scenarios that run without Godot and a JSI
+// runtime are covered: the thread hops of runOnGodotThread() and of
+// callbacks into a waiting JS thread, the call arena, window name lookups
+// and string and array conversion. Method calls, Variant conversion and
+// class lookups need the engine and are measured in the app with
+// RTNGodot.getBridgeStats().
+
+#include "ArrayKernels.h"
+#include "BridgeMetrics.h"
+#include "CallArena.h"
+#include "SyncCall.h"
+#include "TaskExecutor.h"
+#include "TextKernels.h"
+#include "WindowIndex.h"
+#include "alloc_counter.h"
+
+#define LOG_TAG "Bench"
+#include "godot-log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+struct Result {
+	const char *name;
+	uint64_t ops;
+	double ns_per_op;
+	double p99_ns;
+	double allocations_per_op;
+};
+
+// Runs p_op p_batches * p_batch_size times. Each batch is timed as a whole,
+// p99_ns is the 99th percentile of the per-op time of a batch, so ops that
+// are shorter than a clock read can still be measured.
+template <typename F>
+static Result run(const char *p_name, int p_batches, int p_batch_size, F &&p_op) {
+	for (int i = 0; i < p_batch_size * 16; i++) {
+		p_op();
+	}
+	std::vector<double> samples(p_batches);
+	uint64_t allocations = get_allocation_count();
+	Clock::time_point start = Clock::now();
+	for (int b = 0; b < p_batches; b++) {
+		Clock::time_point batch_start = Clock::now();
+		for (int i = 0; i < p_batch_size; i++) {
+			p_op();
+		}
+		samples[b] = std::chrono::duration<double, std::nano>(Clock::now() - batch_start).count() / p_batch_size;
+	}
+	double total_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	uint64_t allocated = get_allocation_count() - allocations;
+
+	std::sort(samples.begin(), samples.end());
+	Result result;
+	result.name = p_name;
+	result.ops = (uint64_t)p_batches * p_batch_size;
+	result.ns_per_op = total_ns / result.ops;
+	result.p99_ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+	result.allocations_per_op = (double)allocated / result.ops;
+	return result;
+}
+
+// Keeps results of lookups from being optimized away.
+static volatile uint64_t counter_sink = 0;
+
+// Size of a godot::Variant in double precision builds.
+struct FakeVariant {
+	alignas(8) uint8_t data[40];
+};
+
+int main() {
+	std::vector<Result> results;
+
+	BridgeMetrics::reset();
+	uint64_t ns = 0;
+	results.push_back(run("metricsRecord", 2000, 256, [&]() {
+		BridgeMetrics::record(BRIDGE_METHOD_CALL, ++ns & 0xffff);
+	}));
+
+	BridgeMetrics::set_enabled(false);
+	results.push_back(run("metricsScopeDisabled", 2000, 256, []() {
+		BridgeMetrics::Scope scope(BRIDGE_METHOD_CALL);
+	}));
+	BridgeMetrics::set_enabled(true);
+	results.push_back(run("metricsScopeEnabled", 2000, 256, []() {
+		BridgeMetrics::Scope scope(BRIDGE_METHOD_CALL);
+	}));
+	BridgeMetrics::set_enabled(false);
+	BridgeMetrics::reset();
+
+	results.push_back(run("arenaCall8Args", 2000, 256, []() {
+		CallArena::Scope scope;
+		ArenaArray<FakeVariant> args(scope, 8);
+		ArenaArray<const FakeVariant *> argptrs(scope, 8);
+		for (int i = 0; i < 8; i++) {
+			argptrs.emplace_back(&args.emplace_back());
+		}
+	}));
+
+	{
+		StdThreadExecutor executor;
+		int counter = 0;
+		auto f = [&]() { counter++; };
+		results.push_back(run("syncCallRoundTrip", 20000, 1, [&]() {
+			executor.run_sync(f);
+		}));
+
+		// The hop of runOnGodotThread(): a queued task, completed back to
+		// the calling thread.
+		results.push_back(run("postRoundTrip", 20000, 1, [&]() {
+			SyncCompletion done;
+			executor.post([&]() { done.complete(); });
+			done.wait();
+		}));
+
+		// A Godot to JS callback while the JS thread waits for the Godot
+		// thread, as JavascriptCallable does for synchronous calls.
+		SyncWaiter *js_waiter = SyncWaiter::get_current();
+		auto callback = [&]() { counter++; };
+		auto call_back = [&]() {
+			SyncCall call(callback);
+			// The JS thread may not be inside its wait yet.
+			while (!js_waiter->post(&call)) {
+				std::this_thread::yield();
+			}
+			call.wait();
+		};
+		results.push_back(run("callbackIntoWaitingThread", 20000, 1, [&]() {
+			executor.run_sync(call_back);
+		}));
+	}
+
+	// Looking up the window of an RTNGodotView by name.
+	WindowIndex windows;
+	std::vector<std::string> window_names;
+	for (uint64_t id = 1; id <= 64; id++) {
+		window_names.push_back("preview_" + std::to_string(id));
+		windows.add(id, window_names.back());
+	}
+	size_t window = 0;
+	results.push_back(run("windowLookup64", 2000, 256, [&]() {
+		const std::vector<uint64_t> *ids = windows.find(window_names[window++ & 63]);
+		counter_sink = ids ? ids->front() : 0;
+	}));
+
+	std::u16string text;
+	while (text.size() < 1024) {
+		text += u"Grüße 日本語 🎮 ";
+	}
+	text.resize(1024);
+	std::vector<char32_t> utf32;
+	results.push_back(run("utf16ToUtf32_1k", 2000, 16, [&]() {
+		utf32.clear();
+		TextKernels::Utf32Collector collector{ utf32 };
+		collector(false, text.data(), text.size());
+		collector.finish();
+	}));
+	std::vector<char16_t> utf16;
+	results.push_back(run("utf32ToUtf16_1k", 2000, 16, [&]() {
+		TextKernels::utf32_to_utf16(utf32.data(), utf32.size(), utf16);
+	}));
+
+	// A string argument converted for a call, with a throttled log on the
+	// call path as the bridge has them, at a disabled and an enabled level.
+	std::u16string argument = u"set_player_name: Grüße";
+	std::vector<char32_t> converted;
+	auto string_call = [&]() {
+		converted.clear();
+		TextKernels::Utf32Collector collector{ converted };
+		collector(false, argument.data(), argument.size());
+		collector.finish();
+	};
+	results.push_back(run("stringCall", 2000, 256, string_call));
+	int previous_level = godot_log_level.exchange(GODOT_LOG_LEVEL_WARN);
+	results.push_back(run("stringCallLogDisabled", 2000, 256, [&]() {
+		string_call();
+		LOG_THROTTLED(GODOT_LOG_LEVEL_INFO, 1000, "string call with %zu characters", converted.size());
+	}));
+	godot_log_level = GODOT_LOG_LEVEL_INFO;
+	results.push_back(run("stringCallLogEnabled", 2000, 256, [&]() {
+		string_call();
+		LOG_THROTTLED(GODOT_LOG_LEVEL_INFO, 1000, "string call with %zu characters", converted.size());
+	}));
+	godot_log_level = previous_level;
+
+	std::vector<double> doubles(1024, 1.5);
+	std::vector<float> floats(1024);
+	results.push_back(run("f64ToF32_1k", 2000, 16, [&]() {
+		ArrayKernels::f64_to_f32(doubles.data(), floats.data(), doubles.size());
+	}));
+
+	printf("{\"backend\":\"%s\",\"benchmarks\":[", ArrayKernels::get_backend());
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result &r = results[i];
+		printf("%s\n{\"name\":\"%s\",\"ops\":%llu,\"nsPerOp\":%.1f,\"p99Ns\":%.1f,\"allocationsPerOp\":%.3f}", i ? "," : "",
+				r.name, (unsigned long long)r.ops, r.ns_per_op, r.p99_ns, r.allocations_per_op);
+	}
+	printf("\n]}\n");
+	return 0;
+}
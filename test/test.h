@@ -0,0 +1,48 @@
+/**************************************************************************/
+/*  test.h                                                                */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+// The tests check with assert(), keep it in every build type.
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <thread>
+
+#define RUN_TEST(m_test) \
+	do { \
+		m_test(); \
+		printf("%s: ok\n", #m_test); \
+	} while (0)
+
+// For tests that bind an executor to the calling thread. The binding hooks
+// the executor into the thread's SyncWaiter for good, so each of them needs
+// a thread of its own.
+#define RUN_TEST_ON_THREAD(m_test) \
+	do { \
+		std::thread thread(m_test); \
+		thread.join(); \
+		printf("%s: ok\n", #m_test); \
+	} while (0)
@@ -0,0 +1,167 @@
+/**************************************************************************/
+/*  test_array_kernels.cpp                                                */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "ArrayKernels.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+static bool same_value(double a, double b) {
+	return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+static std::vector<double> make_values(size_t p_count) {
+	std::vector<double> values(p_count);
+	for (size_t i = 0; i < p_count; i++) {
+		values[i] = (double)i * 1.000001 - 17.25 + 1e-9 * (double)i;
+	}
+	if (p_count > 5) {
+		values[1] = std::numeric_limits<double>::quiet_NaN();
+		values[2] = std::numeric_limits<double>::infinity();
+		values[3] = -0.0;
+		values[4] = 1e300; // Out of float range, becomes infinity.
+		values[5] = 1e-300; // Below float range, becomes 0.
+	}
+	return values;
+}
+
+// Every length up to a few vector widths, at every alignment, so both the
+// vector body and the scalar tail are compared with plain casts.
+static void test_contiguous_matches_scalar() {
+	for (size_t offset = 0; offset < 4; offset++) {
+		for (size_t count = 0; count < 70; count++) {
+			std::vector<double> src = make_values(count + offset);
+			std::vector<float> dst(count + offset + 1, 42.0f);
+			ArrayKernels::f64_to_f32(src.data() + offset, dst.data() + offset, count);
+			for (size_t i = 0; i < count; i++) {
+				assert(same_value(dst[offset + i], (float)src[offset + i]));
+			}
+			assert(dst[offset + count] == 42.0f);
+
+			std::vector<double> back(count + offset + 1, 42.0);
+			ArrayKernels::f32_to_f64(dst.data() + offset, back.data() + offset, count);
+			for (size_t i = 0; i < count; i++) {
+				assert(same_value(back[offset + i], (double)dst[offset + i]));
+			}
+			assert(back[offset + count] == 42.0);
+		}
+	}
+}
+
+static void test_strided_matches_scalar() {
+	const size_t src_stride = 6;
+	const size_t dst_stride = 4;
+	const size_t components = 3;
+	for (size_t elements = 0; elements < 40; elements++) {
+		std::vector<double> src = make_values(elements * src_stride + 1);
+		std::vector<float> dst(elements * dst_stride + 1, 42.0f);
+		ArrayKernels::f64_to_f32_strided(src.data(), src_stride, dst.data(), dst_stride, elements, components);
+		for (size_t e = 0; e < elements; e++) {
+			for (size_t c = 0; c < dst_stride; c++) {
+				float v = dst[e * dst_stride + c];
+				if (c < components) {
+					assert(same_value(v, (float)src[e * src_stride + c]));
+				} else {
+					// Gaps between the elements are left alone.
+					assert(v == 42.0f);
+				}
+			}
+		}
+
+		std::vector<double> back(elements * src_stride + 1, 42.0);
+		ArrayKernels::f32_to_f64_strided(dst.data(), dst_stride, back.data(), src_stride, elements, components);
+		for (size_t e = 0; e < elements; e++) {
+			for (size_t c = 0; c < src_stride; c++) {
+				double v = back[e * src_stride + c];
+				if (c < components) {
+					assert(same_value(v, (double)dst[e * dst_stride + c]));
+				} else {
+					assert(v == 42.0);
+				}
+			}
+		}
+	}
+}
+
+static void test_backend_is_named() {
+	const char *backend = ArrayKernels::get_backend();
+	assert(backend && strlen(backend) > 0);
+	printf("backend: %s\n", backend);
+}
+
+static void test_index_conversion() {
+	size_t index = 42;
+	assert(ArrayKernels::to_index(0.0, index) && index == 0);
+	assert(ArrayKernels::to_index(1e9, index) && index == 1000000000);
+	assert(ArrayKernels::to_index(9007199254740992.0, index));
+	index = 42;
+	assert(!ArrayKernels::to_index(-1.0, index));
+	assert(!ArrayKernels::to_index(1.5, index));
+	assert(!ArrayKernels::to_index(std::numeric_limits<double>::quiet_NaN(), index));
+	assert(!ArrayKernels::to_index(std::numeric_limits<double>::infinity(), index));
+	assert(!ArrayKernels::to_index(-std::numeric_limits<double>::infinity(), index));
+	assert(!ArrayKernels::to_index(1e300, index));
+	assert(index == 42);
+}
+
+static void test_extent() {
+	size_t extent = 0;
+	assert(ArrayKernels::get_extent(5, 3, 0, 3, extent) && extent == 5);
+	assert(ArrayKernels::get_extent(0, 3, 1, 3, extent) && extent == 3);
+	assert(ArrayKernels::get_extent(2, 6, 4, 3, extent) && extent == 2 + 3 * 6 + 3);
+	assert(!ArrayKernels::get_extent(SIZE_MAX - 1, 3, 1, 3, extent));
+	assert(!ArrayKernels::get_extent(0, SIZE_MAX / 2, 4, 1, extent));
+	assert(!ArrayKernels::get_extent(9007199254740992ull, 9007199254740992ull, 1u << 20, 3, extent));
+}
+
+// A fake typed array, e.g. {constructor: {name: "Float64Array"}, buffer,
+// byteOffset: 1e9, length: 1e9}, must not reach outside its buffer.
+static void test_view_bounds() {
+	assert(ArrayKernels::is_view_in_bounds(0, 8, 8, 64));
+	assert(ArrayKernels::is_view_in_bounds(8, 7, 8, 64));
+	assert(ArrayKernels::is_view_in_bounds(64, 0, 8, 64));
+	assert(!ArrayKernels::is_view_in_bounds(8, 8, 8, 64));
+	assert(!ArrayKernels::is_view_in_bounds(72, 0, 8, 64));
+	assert(!ArrayKernels::is_view_in_bounds(1000000000, 1000000000, 8, 64));
+	assert(!ArrayKernels::is_view_in_bounds(0, SIZE_MAX / 4, 8, 64));
+	// Misaligned views would make unaligned float loads.
+	assert(!ArrayKernels::is_view_in_bounds(4, 1, 8, 64));
+	assert(ArrayKernels::is_view_in_bounds(4, 1, 4, 64));
+}
+
+int main() {
+	RUN_TEST(test_contiguous_matches_scalar);
+	RUN_TEST(test_strided_matches_scalar);
+	RUN_TEST(test_backend_is_named);
+	RUN_TEST(test_index_conversion);
+	RUN_TEST(test_extent);
+	RUN_TEST(test_view_bounds);
+	return 0;
+}
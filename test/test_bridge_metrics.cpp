@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*  test_bridge_metrics.cpp                                               */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "BridgeMetrics.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void test_stats_of_recorded_values() {
+	BridgeMetrics::reset();
+	for (uint64_t i = 1; i <= 100; i++) {
+		BridgeMetrics::record(BRIDGE_METHOD_CALL, i * 1000);
+	}
+	BridgeMetricStats stats = BridgeMetrics::get_stats(BRIDGE_METHOD_CALL);
+	assert(stats.count == 100);
+	assert(stats.total_ns == 5050 * 1000);
+	assert(stats.max_ns == 100000);
+	// Percentiles are the upper bound of their bucket, at most 1/8 above the value.
+	assert(stats.p50_ns >= 50000 && stats.p50_ns <= 50000 + 50000 / 8);
+	assert(stats.p99_ns >= 99000 && stats.p99_ns <= 100000);
+
+	// Other metrics are separate.
+	assert(BridgeMetrics::get_stats(BRIDGE_STATIC_CALL).count == 0);
+
+	BridgeMetrics::reset();
+	stats = BridgeMetrics::get_stats(BRIDGE_METHOD_CALL);
+	assert(stats.count == 0 && stats.total_ns == 0 && stats.max_ns == 0);
+	assert(stats.p50_ns == 0 && stats.p99_ns == 0);
+}
+
+// Upper bound of the bucket p_ns falls into. With one sample above it, the
+// median is that bucket's bound and is not clamped to the maximum.
+static uint64_t get_bucket_bound(uint64_t p_ns) {
+	BridgeMetrics::reset();
+	BridgeMetrics::record(BRIDGE_TYPE_LOOKUP, p_ns);
+	BridgeMetrics::record(BRIDGE_TYPE_LOOKUP, UINT64_MAX);
+	return BridgeMetrics::get_stats(BRIDGE_TYPE_LOOKUP).p50_ns;
+}
+
+static void check_bucket(uint64_t p_ns) {
+	uint64_t bound = get_bucket_bound(p_ns);
+	assert(bound >= p_ns);
+	if (p_ns < 8) {
+		// Exact buckets below 8 ns.
+		assert(bound == p_ns);
+	} else {
+		// Sub buckets are 1/8 of their power of two wide.
+		assert(bound - p_ns < p_ns / 8 + 1);
+	}
+	// The bound belongs to the bucket, the next value to the next one.
+	assert(get_bucket_bound(bound) == bound);
+	if (bound < UINT64_MAX) {
+		assert(get_bucket_bound(bound + 1) > bound);
+	}
+}
+
+static void test_histogram_buckets() {
+	for (uint64_t ns = 0; ns <= 4096; ns++) {
+		check_bucket(ns);
+	}
+	for (int bit = 3; bit < 64; bit++) {
+		uint64_t power = 1ull << bit;
+		check_bucket(power - 1);
+		check_bucket(power);
+		check_bucket(power + 1);
+		check_bucket(power + power / 2);
+	}
+	check_bucket(UINT64_MAX);
+	assert(get_bucket_bound(UINT64_MAX) == UINT64_MAX);
+	BridgeMetrics::reset();
+}
+
+static void test_concurrent_records_are_counted() {
+	BridgeMetrics::reset();
+	const int THREADS = 4;
+	const uint64_t RECORDS = 100000;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < THREADS; t++) {
+		threads.emplace_back([t]() {
+			for (uint64_t i = 0; i < RECORDS; i++) {
+				BridgeMetrics::record(BRIDGE_JS_CALLABLE, 100 + t);
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	BridgeMetricStats stats = BridgeMetrics::get_stats(BRIDGE_JS_CALLABLE);
+	assert(stats.count == THREADS * RECORDS);
+	assert(stats.total_ns == RECORDS * (100 + 101 + 102 + 103));
+	assert(stats.max_ns == 103);
+	assert(stats.p99_ns == 103);
+	BridgeMetrics::reset();
+}
+
+static void test_scope_records_only_when_enabled() {
+	BridgeMetrics::reset();
+	BridgeMetrics::set_enabled(false);
+	{
+		BridgeMetrics::Scope scope(BRIDGE_TO_VARIANT);
+	}
+	assert(BridgeMetrics::get_stats(BRIDGE_TO_VARIANT).count == 0);
+
+	BridgeMetrics::set_enabled(true);
+	{
+		BridgeMetrics::Scope scope(BRIDGE_TO_VARIANT);
+	}
+	BridgeMetrics::set_enabled(false);
+	assert(BridgeMetrics::get_stats(BRIDGE_TO_VARIANT).count == 1);
+}
+
+static void test_metrics_are_named() {
+	for (int i = 0; i < BRIDGE_METRIC_MAX; i++) {
+		assert(std::string(BridgeMetrics::get_name((BridgeMetric)i)) != "unknown");
+	}
+}
+
+int main() {
+	RUN_TEST(test_stats_of_recorded_values);
+	RUN_TEST(test_histogram_buckets);
+	RUN_TEST(test_concurrent_records_are_counted);
+	RUN_TEST(test_scope_records_only_when_enabled);
+	RUN_TEST(test_metrics_are_named);
+	return 0;
+}
@@ -0,0 +1,139 @@
+/**************************************************************************/
+/*  test_call_arena.cpp                                                   */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "CallArena.h"
+#include "alloc_counter.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+static void test_allocations_are_aligned() {
+	CallArena::Scope scope;
+	CallArena &arena = scope.get_arena();
+	char *c = arena.allocate<char>(3);
+	double *d = arena.allocate<double>(2);
+	long double *ld = arena.allocate<long double>(1);
+	assert(c && d && ld);
+	assert((uintptr_t)d % alignof(double) == 0);
+	assert((uintptr_t)ld % alignof(long double) == 0);
+	assert((void *)d > (void *)c);
+}
+
+static void test_scope_releases_in_stack_order() {
+	CallArena::Scope outer;
+	int *first = outer.get_arena().allocate<int>(4);
+	int *nested = nullptr;
+	{
+		CallArena::Scope inner;
+		nested = inner.get_arena().allocate<int>(4);
+		assert(nested != first);
+	}
+	// The inner scope's memory is handed out again.
+	int *again = outer.get_arena().allocate<int>(4);
+	assert(again == nested);
+}
+
+static void test_overflow_block_is_reused() {
+	uint64_t before = CallArena::get_stats().heap_allocations;
+	{
+		CallArena::Scope scope;
+		scope.get_arena().allocate<uint8_t>(CallArena::INLINE_SIZE + 1);
+	}
+	assert(CallArena::get_stats().heap_allocations == before + 1);
+	assert(CallArena::get_stats().high_water >= CallArena::INLINE_SIZE + 1);
+
+	// The block is kept as a spare, the next overflow does not allocate.
+	for (int i = 0; i < 100; i++) {
+		CallArena::Scope scope;
+		scope.get_arena().allocate<uint8_t>(CallArena::INLINE_SIZE + 1);
+	}
+	assert(CallArena::get_stats().heap_allocations == before + 1);
+}
+
+static void test_array_destroys_elements() {
+	CallArena::Scope scope;
+	{
+		ArenaArray<std::string> strings(scope, 3);
+		strings.emplace_back("a");
+		strings.emplace_back(100, 'b');
+		assert(strings.size() == 2);
+		assert(strings[0] == "a");
+		assert(strings[1].size() == 100);
+	}
+	// Nothing to check directly, leaks show up under sanitizers.
+}
+
+// Size of a godot::Variant in double precision builds, the larger one.
+struct FakeVariant {
+	alignas(8) uint8_t data[40];
+
+	explicit FakeVariant(int p_value) { data[0] = (uint8_t)p_value; }
+};
+
+// The argument conversion of a bridge call, see GodotHostObject::get().
+// p_depth nested calls model Godot calling back into JS during the call.
+static int fake_call(int p_argcount, int p_depth) {
+	CallArena::Scope scope;
+	ArenaArray<FakeVariant> args(scope, p_argcount);
+	ArenaArray<const FakeVariant *> argptrs(scope, p_argcount);
+	for (int i = 0; i < p_argcount; i++) {
+		argptrs.emplace_back(&args.emplace_back(i));
+	}
+	int sum = 0;
+	for (int i = 0; i < p_argcount; i++) {
+		sum += argptrs[i]->data[0];
+	}
+	return p_depth > 0 ? sum + fake_call(p_argcount, p_depth - 1) : sum;
+}
+
+static void test_calls_with_few_arguments_do_not_allocate() {
+	// A fresh thread, so the arena starts empty like on a new JS thread.
+	std::thread thread([]() {
+		uint64_t allocations = get_allocation_count();
+		uint64_t heap_allocations = CallArena::get_stats().heap_allocations;
+		int sum = 0;
+		for (int round = 0; round < 10000; round++) {
+			for (int argcount = 0; argcount <= 8; argcount++) {
+				sum += fake_call(argcount, 3);
+			}
+		}
+		assert(sum > 0);
+		assert(get_allocation_count() == allocations);
+		assert(CallArena::get_stats().heap_allocations == heap_allocations);
+	});
+	thread.join();
+}
+
+int main() {
+	RUN_TEST(test_allocations_are_aligned);
+	RUN_TEST(test_scope_releases_in_stack_order);
+	RUN_TEST(test_overflow_block_is_reused);
+	RUN_TEST(test_array_destroys_elements);
+	RUN_TEST(test_calls_with_few_arguments_do_not_allocate);
+	return 0;
+}
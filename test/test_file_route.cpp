@@ -0,0 +1,61 @@
+/**************************************************************************/
+/*  test_file_route.cpp                                                   */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "FileRoute.h"
+
+#include <cstring>
+
+static void test_android_file_routes() {
+	assert(FileRoute::get_android_file_route("res://icon.png") == FileRoute::ROUTE_NATIVE);
+	assert(FileRoute::get_android_file_route("uid://b2x8e0n3k1") == FileRoute::ROUTE_NATIVE);
+	assert(FileRoute::get_android_file_route("user://save.dat") == FileRoute::ROUTE_NATIVE);
+	assert(FileRoute::get_android_file_route("/data/user/0/app/files/main.pck") == FileRoute::ROUTE_JAVA);
+	assert(FileRoute::get_android_file_route("/sdcard/Download/level.tres") == FileRoute::ROUTE_JAVA);
+	assert(FileRoute::get_android_file_route("icon.png") == FileRoute::ROUTE_JAVA);
+	// Only the scheme at the start counts.
+	assert(FileRoute::get_android_file_route("/tmp/res://x") == FileRoute::ROUTE_JAVA);
+}
+
+static void test_android_dir_routes() {
+	assert(FileRoute::get_android_dir_route("user://saves") == FileRoute::ROUTE_NATIVE);
+	assert(FileRoute::get_android_dir_route("res://levels") == FileRoute::ROUTE_JAVA);
+	assert(FileRoute::get_android_dir_route("/data/user/0/app/files") == FileRoute::ROUTE_JAVA);
+}
+
+static void test_host_routes_are_native() {
+	assert(FileRoute::get_file_route("/tmp/level.tres") == FileRoute::ROUTE_NATIVE);
+	assert(FileRoute::get_dir_route("res://levels") == FileRoute::ROUTE_NATIVE);
+	assert(strcmp(FileRoute::get_name(FileRoute::ROUTE_NATIVE), "native") == 0);
+	assert(strcmp(FileRoute::get_name(FileRoute::ROUTE_JAVA), "java") == 0);
+}
+
+int main() {
+	RUN_TEST(test_android_file_routes);
+	RUN_TEST(test_android_dir_routes);
+	RUN_TEST(test_host_routes_are_native);
+	return 0;
+}
@@ -0,0 +1,73 @@
+/**************************************************************************/
+/*  test_godot_log.cpp                                                    */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+// Verbose and debug logs are compiled out, as in release builds.
+#define GODOT_LOG_MIN_LEVEL GODOT_LOG_LEVEL_INFO
+#define LOG_TAG "LogTest"
+#include "godot-log.h"
+
+static int evaluated = 0;
+
+static int count_evaluation() {
+	return ++evaluated;
+}
+
+static void test_compiled_out_levels_are_not_evaluated() {
+	evaluated = 0;
+	for (int i = 0; i < 10; i++) {
+		LOGV("%d", count_evaluation());
+		LOG_THROTTLED(GODOT_LOG_LEVEL_VERBOSE, 0, "%d", count_evaluation());
+	}
+	assert(evaluated == 0);
+}
+
+static void test_runtime_level_is_checked_first() {
+	evaluated = 0;
+	int previous = godot_log_level.exchange(GODOT_LOG_LEVEL_ERROR);
+	LOG_THROTTLED(GODOT_LOG_LEVEL_WARN, 0, "%d", count_evaluation());
+	assert(evaluated == 0);
+	godot_log_level = previous;
+}
+
+static void test_throttled_logs_once_per_interval() {
+	evaluated = 0;
+	for (int i = 0; i < 100; i++) {
+		LOG_THROTTLED(GODOT_LOG_LEVEL_INFO, 60000, "throttled %d", count_evaluation());
+	}
+	assert(evaluated == 1);
+
+	// Separate call sites are throttled separately.
+	LOG_THROTTLED(GODOT_LOG_LEVEL_INFO, 60000, "throttled %d", count_evaluation());
+	assert(evaluated == 2);
+}
+
+int main() {
+	RUN_TEST(test_compiled_out_levels_are_not_evaluated);
+	RUN_TEST(test_runtime_level_is_checked_first);
+	RUN_TEST(test_throttled_logs_once_per_interval);
+	return 0;
+}
@@ -0,0 +1,88 @@
+/**************************************************************************/
+/*  test_startup_trace.cpp                                                */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "StartupTrace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static void test_phases_are_recorded_once() {
+	// Before begin() there is nothing to measure against.
+	StartupTrace::mark(STARTUP_LIBRARY_LOADED);
+	assert(StartupTrace::get_report().phase_ns[STARTUP_LIBRARY_LOADED] == 0);
+
+	StartupTrace::begin();
+	StartupTrace::mark(STARTUP_LIBRARY_LOADED);
+	uint64_t loaded = StartupTrace::get_report().phase_ns[STARTUP_LIBRARY_LOADED];
+	assert(loaded > 0);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	StartupTrace::mark(STARTUP_LIBRARY_LOADED);
+	StartupTrace::mark(STARTUP_INSTANCE_CREATED);
+	StartupTrace::Report report = StartupTrace::get_report();
+	assert(report.phase_ns[STARTUP_LIBRARY_LOADED] == loaded);
+	assert(report.phase_ns[STARTUP_INSTANCE_CREATED] > loaded);
+	assert(report.phase_ns[STARTUP_FIRST_ITERATION] == 0);
+	assert(!StartupTrace::is_finished());
+
+	StartupTrace::mark(STARTUP_FIRST_ITERATION);
+	assert(StartupTrace::is_finished());
+
+	// A new trace starts over.
+	StartupTrace::begin();
+	assert(StartupTrace::get_report().phase_ns[STARTUP_LIBRARY_LOADED] == 0);
+	assert(!StartupTrace::is_finished());
+}
+
+static void test_report_is_written_as_json() {
+	StartupTrace::begin();
+	StartupTrace::set_from_snapshot(true);
+	StartupTrace::mark(STARTUP_FIRST_ITERATION);
+	std::string path = "startup_trace_test.json";
+	assert(StartupTrace::write(path));
+
+	std::ifstream in(path);
+	std::stringstream json;
+	json << in.rdbuf();
+	std::string text = json.str();
+	assert(text.find("\"fromSnapshot\":true") != std::string::npos);
+	assert(text.find("\"libraryLoaded\":0") != std::string::npos);
+	assert(text.find("\"firstIteration\":0") == std::string::npos);
+	remove(path.c_str());
+	StartupTrace::set_from_snapshot(false);
+
+	assert(!StartupTrace::write("/nonexistent-dir/startup.json"));
+}
+
+int main() {
+	RUN_TEST(test_phases_are_recorded_once);
+	RUN_TEST(test_report_is_written_as_json);
+	return 0;
+}
@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*  test_sync_call.cpp                                                    */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "SyncCall.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+static void test_function_calls_referenced_callable() {
+	int calls = 0;
+	auto f = [&]() { calls++; };
+	SyncFunction func(f);
+	func();
+	func();
+	assert(calls == 2);
+}
+
+static void test_completion_wakes_waiter() {
+	SyncCompletion completion;
+	assert(!completion.is_done());
+	assert(completion.get_waiter() == SyncWaiter::get_current());
+	std::thread other([&]() { completion.complete(); });
+	completion.wait();
+	assert(completion.is_done());
+	other.join();
+}
+
+static void test_post_needs_waiting_thread() {
+	SyncWaiter *waiter = SyncWaiter::get_current();
+	int calls = 0;
+	auto f = [&]() { calls++; };
+	SyncCall call(f);
+	assert(!waiter->post(&call));
+	assert(calls == 0);
+}
+
+static void test_posted_call_runs_while_waiting() {
+	SyncWaiter *waiter = SyncWaiter::get_current();
+	std::thread::id main_id = std::this_thread::get_id();
+	SyncCompletion completion;
+	std::thread::id ran_on;
+
+	std::thread other([&]() {
+		auto f = [&]() { ran_on = std::this_thread::get_id(); };
+		SyncCall call(f);
+		// Retry until the main thread is inside wait().
+		while (!waiter->post(&call)) {
+			std::this_thread::yield();
+		}
+		call.wait();
+		completion.complete();
+	});
+	completion.wait();
+	other.join();
+	assert(ran_on == main_id);
+}
+
+static void test_call_rethrows_to_caller() {
+	auto f = []() { throw std::logic_error("failed"); };
+	SyncCall call(f);
+	std::thread other([&]() { call.run(); });
+	bool caught = false;
+	try {
+		call.wait();
+	} catch (const std::logic_error &) {
+		caught = true;
+	}
+	other.join();
+	assert(caught);
+}
+
+int main() {
+	RUN_TEST(test_function_calls_referenced_callable);
+	RUN_TEST(test_completion_wakes_waiter);
+	RUN_TEST(test_post_needs_waiting_thread);
+	RUN_TEST(test_posted_call_runs_while_waiting);
+	RUN_TEST(test_call_rethrows_to_caller);
+	return 0;
+}
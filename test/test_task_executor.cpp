@@ -0,0 +1,331 @@
+/**************************************************************************/
+/*  test_task_executor.cpp                                                */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "TaskExecutor.h"
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Runs its tasks on the thread that calls run_pending(), like the platform
+// executors do from their run loop.
+class ManualExecutor : public TaskExecutor {
+public:
+	std::atomic<int> wakes = 0;
+
+	using TaskExecutor::shut_down;
+
+protected:
+	void wake() override {
+		wakes++;
+	}
+};
+
+static void test_lanes_run_by_priority() {
+	ManualExecutor executor;
+	executor.bind_current_thread();
+	std::string order;
+	executor.post([&]() { order += "b"; }, TASK_PRIORITY_BACKGROUND);
+	executor.post([&]() { order += "f"; }, TASK_PRIORITY_FRAME);
+	executor.post([&]() { order += "u"; }, TASK_PRIORITY_URGENT);
+	assert(executor.wakes == 1);
+
+	assert(executor.run_pending() == 3);
+	assert(order == "ufb");
+	assert(executor.get_stats().count == 3);
+	assert(executor.get_stats(TASK_PRIORITY_URGENT).count == 1);
+
+	// The wake request was consumed, the next post wakes again.
+	executor.post([]() {});
+	assert(executor.wakes == 2);
+	executor.run_pending();
+}
+
+static void test_enqueue_runs_inline_on_executor_thread() {
+	ManualExecutor executor;
+	executor.bind_current_thread();
+	bool ran = false;
+	executor.enqueue([&]() { ran = true; });
+	assert(ran);
+	assert(executor.wakes == 0);
+
+	std::thread other([&]() {
+		assert(!executor.is_current_thread());
+		executor.enqueue([&]() { ran = false; });
+	});
+	other.join();
+	assert(ran);
+	assert(executor.run_pending() == 1);
+	assert(!ran);
+}
+
+static void test_background_waits_for_idle_time() {
+	ManualExecutor executor;
+	executor.bind_current_thread();
+	ThreadConfig config;
+	config.frame_reserve_us = 50000;
+	executor.configure(config);
+
+	int ran = 0;
+	executor.post([&]() { ran++; }, TASK_PRIORITY_BACKGROUND);
+	executor.post([&]() { ran++; }, TASK_PRIORITY_BACKGROUND);
+
+	// The deadline is inside the reserve, nothing may start before the frame.
+	auto now = std::chrono::steady_clock::now();
+	executor.begin_frame(now + std::chrono::milliseconds(40));
+	assert(executor.run_pending() == 0);
+	assert(executor.get_stats(TASK_PRIORITY_BACKGROUND).deferred == 1);
+
+	// After the frame, at least one deferred task runs even without time left.
+	assert(executor.run_idle() == 1);
+	assert(ran == 1);
+
+	// Without frames nothing is deferred anymore.
+	int wakes = executor.wakes;
+	executor.end_frames();
+	assert(executor.wakes == wakes + 1);
+	assert(executor.run_pending() == 1);
+	assert(ran == 2);
+}
+
+static void test_run_sync_on_thread() {
+	StdThreadExecutor executor;
+	std::thread::id caller = std::this_thread::get_id();
+	std::thread::id ran_on;
+	auto f = [&]() { ran_on = std::this_thread::get_id(); };
+	executor.run_sync(f);
+	assert(ran_on != caller);
+	assert(executor.get_sync_stats().count == 1);
+
+	// Higher lanes run first, a synchronous call waits for them.
+	std::string order;
+	executor.post([&]() { order += "1"; });
+	executor.post([&]() { order += "2"; });
+	auto g = [&]() { order += "3"; };
+	executor.run_sync(g, TASK_PRIORITY_BACKGROUND);
+	assert(order == "123");
+}
+
+// Synchronous calls from another thread queue the caller's stack frame,
+// after the first call of a thread they never allocate.
+static void test_sync_calls_do_not_allocate() {
+	StdThreadExecutor executor;
+	const int CALLS = 100000;
+	int counter = 0;
+	auto f = [&]() { counter++; };
+	executor.run_sync(f);
+
+	uint64_t allocations = get_allocation_count();
+	for (int i = 1; i < CALLS; i++) {
+		executor.run_sync(f);
+	}
+	assert(get_allocation_count() == allocations);
+	assert(counter == CALLS);
+
+	TaskStats stats = executor.get_sync_stats();
+	assert(stats.count == (uint64_t)CALLS);
+	printf("%d sync calls: %.0f ns average round trip, %.0f ns max\n", CALLS,
+			(double)stats.total_latency_ns / stats.count, (double)stats.max_latency_ns);
+}
+
+// Two executors that synchronously call into each other, like Godot calling
+// a JS callback that calls back into Godot. Each waiting thread keeps
+// running the calls queued for it, so the chain unwinds without deadlock.
+static void nested_call(StdThreadExecutor *p_executors[2], int p_side, int p_depth, int &r_deepest) {
+	if (p_depth == 0) {
+		return;
+	}
+	assert(p_executors[p_side]->is_current_thread());
+	r_deepest++;
+	int other = 1 - p_side;
+	auto f = [&]() { nested_call(p_executors, other, p_depth - 1, r_deepest); };
+	p_executors[other]->run_sync(f);
+}
+
+static void test_nested_sync_calls_do_not_deadlock() {
+	StdThreadExecutor godot;
+	StdThreadExecutor js;
+	StdThreadExecutor *executors[2] = { &godot, &js };
+	const int DEPTH = 40;
+
+	int deepest = 0;
+	auto f = [&]() { nested_call(executors, 0, DEPTH, deepest); };
+	godot.run_sync(f);
+	assert(deepest == DEPTH);
+
+	// Several callers at once, starting on both sides.
+	const int CALLERS = 4;
+	const int ROUNDS = 50;
+	std::thread callers[CALLERS];
+	int totals[CALLERS] = {};
+	for (int i = 0; i < CALLERS; i++) {
+		callers[i] = std::thread([&, i]() {
+			for (int round = 0; round < ROUNDS; round++) {
+				int side = (i + round) % 2;
+				auto g = [&]() { nested_call(executors, side, DEPTH, totals[i]); };
+				executors[side]->run_sync(g);
+			}
+		});
+	}
+	for (std::thread &caller : callers) {
+		caller.join();
+	}
+	for (int total : totals) {
+		assert(total == DEPTH * ROUNDS);
+	}
+}
+
+// A thread without an executor (the JS thread) receives calls through its
+// SyncWaiter inbox while it waits for the Godot thread.
+static void test_nested_call_through_waiter_inbox() {
+	StdThreadExecutor godot;
+	SyncWaiter *js_waiter = SyncWaiter::get_current();
+	std::thread::id js_thread = std::this_thread::get_id();
+	bool ran_on_js = false;
+
+	auto callback = [&]() { ran_on_js = std::this_thread::get_id() == js_thread; };
+	auto f = [&]() {
+		SyncCall call(callback);
+		// The JS thread is blocked in run_sync(), so it has to accept the call.
+		assert(js_waiter->post(&call));
+		call.wait();
+	};
+	godot.run_sync(f);
+	assert(ran_on_js);
+}
+
+static void test_sync_call_rethrows() {
+	StdThreadExecutor executor;
+	auto f = []() { throw std::logic_error("failed on the executor"); };
+	bool caught = false;
+	try {
+		executor.run_sync(f);
+	} catch (const std::logic_error &e) {
+		caught = std::string(e.what()) == "failed on the executor";
+	}
+	assert(caught);
+
+	// The executor thread survived and keeps running calls.
+	int value = 0;
+	auto g = [&]() { value = 1; };
+	executor.run_sync(g);
+	assert(value == 1);
+}
+
+static void test_shut_down_fails_waiting_callers() {
+	ManualExecutor executor;
+	executor.bind_current_thread();
+
+	std::atomic<int> failed = 0;
+	std::atomic<bool> ran = false;
+	auto caller = [&]() {
+		auto f = [&]() { ran = true; };
+		try {
+			executor.run_sync(f);
+		} catch (const std::runtime_error &) {
+			failed++;
+		}
+	};
+	std::thread waiting(caller);
+	while (executor.wakes == 0) {
+		std::this_thread::yield();
+	}
+	executor.post([&]() { ran = true; });
+	executor.shut_down();
+	waiting.join();
+	assert(failed == 1);
+
+	// Later calls fail right away, later tasks are dropped.
+	std::thread late(caller);
+	late.join();
+	assert(failed == 2);
+	executor.post([&]() { ran = true; });
+	assert(executor.run_pending() == 0);
+	assert(!ran);
+}
+
+static void test_destructor_runs_queued_tasks() {
+	std::atomic<bool> release = false;
+	int ran = 0;
+	{
+		StdThreadExecutor executor;
+		executor.post([&]() {
+			while (!release) {
+				std::this_thread::yield();
+			}
+		});
+		executor.post([&]() { ran++; });
+		executor.post([&]() { ran++; }, TASK_PRIORITY_BACKGROUND);
+		release = true;
+	}
+	assert(ran == 2);
+}
+
+// The waiter of a thread outlives the executors bound to it, a gone
+// executor must not be drained by later waits, and must not unbind the
+// executor that replaced it.
+static void test_unbind_on_destruction() {
+	StdThreadExecutor other;
+	ManualExecutor *replaced = new ManualExecutor();
+	replaced->bind_current_thread();
+	{
+		ManualExecutor current;
+		current.bind_current_thread();
+		delete replaced;
+
+		// While this thread waits for the other executor, it still runs the
+		// synchronous call queued for the current one.
+		int value = 0;
+		auto g = [&]() { value = 1; };
+		auto f = [&]() { current.run_sync(g); };
+		other.run_sync(f);
+		assert(value == 1);
+	}
+
+	int value = 0;
+	auto h = [&]() { value = 2; };
+	other.run_sync(h);
+	assert(value == 2);
+}
+
+int main() {
+	RUN_TEST_ON_THREAD(test_lanes_run_by_priority);
+	RUN_TEST_ON_THREAD(test_enqueue_runs_inline_on_executor_thread);
+	RUN_TEST_ON_THREAD(test_background_waits_for_idle_time);
+	RUN_TEST(test_run_sync_on_thread);
+	RUN_TEST(test_sync_calls_do_not_allocate);
+	RUN_TEST(test_nested_sync_calls_do_not_deadlock);
+	RUN_TEST(test_nested_call_through_waiter_inbox);
+	RUN_TEST(test_sync_call_rethrows);
+	RUN_TEST_ON_THREAD(test_shut_down_fails_waiting_callers);
+	RUN_TEST(test_destructor_runs_queued_tasks);
+	RUN_TEST_ON_THREAD(test_unbind_on_destruction);
+	return 0;
+}
@@ -0,0 +1,225 @@
+/**************************************************************************/
+/*  test_text_kernels.cpp                                                 */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "TextKernels.h"
+#include "alloc_counter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct Sample {
+	std::u32string utf32;
+	std::u16string utf16;
+};
+
+static const Sample SAMPLES[] = {
+	{ U"", u"" },
+	{ U"Hello, world", u"Hello, world" },
+	{ U"Grüße aus Köln, ça va?", u"Grüße aus Köln, ça va?" },
+	{ U"Ελληνικά και кириллица", u"Ελληνικά και кириллица" },
+	{ U"日本語のテキスト、中文和한국어", u"日本語のテキスト、中文和한국어" },
+	{ U"עברית ועربية", u"עברית ועربية" },
+	{ U"é ñ combining marks", u"é ñ combining marks" },
+	{ U"🎮 Godot 🚀 emoji 👩‍💻", u"🎮 Godot 🚀 emoji 👩‍💻" },
+	{ U"𝄞𝄢 outside the BMP 𠜎", u"𝄞𝄢 outside the BMP 𠜎" },
+};
+
+static std::u32string collect(const std::vector<std::pair<const char16_t *, size_t>> &p_chunks) {
+	std::vector<char32_t> out;
+	TextKernels::Utf32Collector collector{ out };
+	for (const std::pair<const char16_t *, size_t> &chunk : p_chunks) {
+		collector(false, chunk.first, chunk.second);
+	}
+	collector.finish();
+	return std::u32string(out.begin(), out.end());
+}
+
+static void test_utf32_to_utf16() {
+	std::vector<char16_t> out;
+	for (const Sample &sample : SAMPLES) {
+		TextKernels::utf32_to_utf16(sample.utf32.data(), sample.utf32.size(), out);
+		assert(std::u16string(out.begin(), out.end()) == sample.utf16);
+	}
+
+	// Not a Unicode character.
+	const char32_t invalid[] = { 'a', 0x110000, 'b' };
+	TextKernels::utf32_to_utf16(invalid, 3, out);
+	assert(std::u16string(out.begin(), out.end()) == u"a�b");
+}
+
+static void test_utf16_to_utf32_in_chunks() {
+	for (const Sample &sample : SAMPLES) {
+		const char16_t *data = sample.utf16.data();
+		size_t len = sample.utf16.size();
+		assert(collect({ { data, len } }) == sample.utf32);
+		// Every split point, including the middle of a surrogate pair.
+		for (size_t split = 0; split <= len; split++) {
+			assert(collect({ { data, split }, { data + split, len - split } }) == sample.utf32);
+		}
+	}
+}
+
+static void test_mixed_chunks() {
+	// JSI can hand out an ASCII chunk between two UTF-16 ones.
+	std::vector<char32_t> out;
+	TextKernels::Utf32Collector collector{ out };
+	const char16_t first[] = { u'ö', 0xd83c };
+	const uint8_t ascii[] = { 'a', 'b' };
+	const char16_t last[] = { 0xdfae };
+	collector(false, first, 2);
+	collector(true, ascii, 2);
+	collector(false, last, 1);
+	collector.finish();
+	// The high surrogate is not followed by its pair, both halves are kept.
+	assert(std::u32string(out.begin(), out.end()) == std::u32string({ U'ö', 0xd83c, 'a', 'b', 0xdfae }));
+}
+
+static void test_unpaired_surrogates() {
+	std::u16string lone_high = { 'a', 0xd800, 'b' };
+	assert(collect({ { lone_high.data(), lone_high.size() } }) == std::u32string({ 'a', 0xd800, 'b' }));
+	std::u16string lone_low = { 0xdc00, 'x' };
+	assert(collect({ { lone_low.data(), lone_low.size() } }) == std::u32string({ 0xdc00, 'x' }));
+	std::u16string trailing_high = { 'x', 0xdbff };
+	assert(collect({ { trailing_high.data(), trailing_high.size() } }) == std::u32string({ 'x', 0xdbff }));
+}
+
+static void test_narrowing() {
+	std::u32string ascii = U"plain ascii";
+	assert(TextKernels::max_char(ascii.data(), ascii.size()) < 0x80);
+	std::string narrow(ascii.size(), '\0');
+	TextKernels::narrow_ascii(ascii.data(), narrow.data(), ascii.size());
+	assert(narrow == "plain ascii");
+
+	std::u32string bmp = U"Grüße 日本";
+	uint32_t max = TextKernels::max_char(bmp.data(), bmp.size());
+	assert(max >= 0x80 && max < 0x10000);
+	std::u16string narrow_bmp(bmp.size(), u'\0');
+	TextKernels::narrow_bmp(bmp.data(), narrow_bmp.data(), bmp.size());
+	assert(narrow_bmp == u"Grüße 日本");
+
+	std::u32string astral = U"a🎮";
+	assert(TextKernels::max_char(astral.data(), astral.size()) >= 0x10000);
+
+	std::u16string wide = u"abc";
+	assert(!TextKernels::has_surrogates(wide.data(), wide.size()));
+	std::u16string pair = u"a🎮";
+	assert(TextKernels::has_surrogates(pair.data(), pair.size()));
+}
+
+static void test_reused_buffers_do_not_allocate() {
+	std::u16string text = SAMPLES[7].utf16 + SAMPLES[4].utf16;
+	std::vector<char32_t> utf32;
+	std::vector<char16_t> utf16;
+	for (int i = 0; i < 2; i++) {
+		uint64_t allocations = get_allocation_count();
+		utf32.clear();
+		TextKernels::Utf32Collector collector{ utf32 };
+		collector(false, text.data(), text.size());
+		collector.finish();
+		TextKernels::utf32_to_utf16(utf32.data(), utf32.size(), utf16);
+		// Only the first round grows the buffers.
+		assert(i == 0 || get_allocation_count() == allocations);
+	}
+}
+
+static void test_large_buffers_are_trimmed() {
+	std::vector<char32_t> small(1024);
+	const char32_t *data = small.data();
+	TextKernels::trim_buffer(small);
+	assert(small.data() == data);
+
+	std::vector<char32_t> large(TextKernels::MAX_KEPT_BUFFER_BYTES / sizeof(char32_t) + 1);
+	TextKernels::trim_buffer(large);
+	assert(large.capacity() == 0);
+}
+
+static void test_throughput() {
+	typedef std::chrono::steady_clock Clock;
+	const size_t CHARS = 1 << 20;
+	const int ROUNDS = 20;
+
+	std::u16string bmp;
+	std::u16string mixed;
+	while (bmp.size() < CHARS) {
+		bmp += SAMPLES[4].utf16;
+		mixed += SAMPLES[2].utf16 + SAMPLES[7].utf16;
+	}
+	std::vector<uint8_t> ascii(CHARS, 'a');
+
+	std::vector<char32_t> utf32;
+	std::vector<char16_t> utf16;
+	auto measure = [&](const char *p_name, size_t p_units, auto p_convert) {
+		p_convert();
+		Clock::time_point start = Clock::now();
+		for (int i = 0; i < ROUNDS; i++) {
+			p_convert();
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		printf("%s: %.0f M chars/s\n", p_name, (double)p_units * ROUNDS / seconds / 1e6);
+	};
+	measure("ASCII to UTF-32", ascii.size(), [&]() {
+		utf32.clear();
+		TextKernels::Utf32Collector collector{ utf32 };
+		collector(true, ascii.data(), ascii.size());
+	});
+	measure("UTF-16 (BMP) to UTF-32", bmp.size(), [&]() {
+		utf32.clear();
+		TextKernels::Utf32Collector collector{ utf32 };
+		collector(false, bmp.data(), bmp.size());
+		collector.finish();
+	});
+	measure("UTF-16 (with surrogates) to UTF-32", mixed.size(), [&]() {
+		utf32.clear();
+		TextKernels::Utf32Collector collector{ utf32 };
+		collector(false, mixed.data(), mixed.size());
+		collector.finish();
+	});
+	std::u32string bmp32 = collect({ { bmp.data(), bmp.size() } });
+	measure("UTF-32 (BMP) to UTF-16", bmp32.size(), [&]() {
+		utf16.resize(bmp32.size());
+		TextKernels::narrow_bmp(bmp32.data(), utf16.data(), bmp32.size());
+	});
+	std::u32string mixed32 = collect({ { mixed.data(), mixed.size() } });
+	measure("UTF-32 (with astral) to UTF-16", mixed32.size(), [&]() {
+		TextKernels::utf32_to_utf16(mixed32.data(), mixed32.size(), utf16);
+	});
+	assert(utf16.size() == mixed.size());
+}
+
+int main() {
+	RUN_TEST(test_utf32_to_utf16);
+	RUN_TEST(test_utf16_to_utf32_in_chunks);
+	RUN_TEST(test_mixed_chunks);
+	RUN_TEST(test_unpaired_surrogates);
+	RUN_TEST(test_narrowing);
+	RUN_TEST(test_reused_buffers_do_not_allocate);
+	RUN_TEST(test_large_buffers_are_trimmed);
+	RUN_TEST(test_throughput);
+	return 0;
+}
@@ -0,0 +1,198 @@
+/**************************************************************************/
+/*  test_window_index.cpp                                                 */
+/**************************************************************************/
+/* Copyright (c) 2024-2025 Slay GmbH                                      */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test.h"
+
+#include "WindowIndex.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Stand-in for a SceneTree: node 0 is the root, ids are index + 1.
+struct TestNode {
+	std::string name;
+	bool window = false;
+	std::vector<size_t> children;
+};
+
+static const size_t NODE_COUNT = 10000;
+static const size_t WINDOW_EVERY = 100;
+
+// Nodes with a branching factor of 8, every WINDOW_EVERY-th node is a
+// Window. Every tenth Window shares its name with another one.
+static std::vector<TestNode> build_tree() {
+	std::vector<TestNode> nodes(NODE_COUNT);
+	for (size_t i = 0; i < NODE_COUNT; i++) {
+		nodes[i].name = "Node" + std::to_string(i);
+		if (i > 0 && i % WINDOW_EVERY == 0) {
+			nodes[i].window = true;
+			size_t window = i / WINDOW_EVERY;
+			nodes[i].name = "Window" + std::to_string(window % 10 == 0 ? window / 10 : window);
+		}
+		if (i > 0) {
+			nodes[(i - 1) / 8].children.push_back(i);
+		}
+	}
+	return nodes;
+}
+
+// The first Window with the name in a pre-order walk, which is what the
+// index returns for a tree scanned at once. find_child(), used before the
+// index, stops at the first node with the name whether or not it is a
+// Window, see test_non_window_nodes_are_ignored().
+static uint64_t find_linear(const std::vector<TestNode> &p_nodes, size_t p_node, const std::string &p_name) {
+	for (size_t child : p_nodes[p_node].children) {
+		if (p_nodes[child].window && p_nodes[child].name == p_name) {
+			return child + 1;
+		}
+		uint64_t found = find_linear(p_nodes, child, p_name);
+		if (found) {
+			return found;
+		}
+	}
+	return 0;
+}
+
+// What WindowRegistry::scan() does.
+static void scan(const std::vector<TestNode> &p_nodes, size_t p_node, WindowIndex &r_index) {
+	for (size_t child : p_nodes[p_node].children) {
+		if (p_nodes[child].window) {
+			r_index.add(child + 1, p_nodes[child].name);
+		}
+		scan(p_nodes, child, r_index);
+	}
+}
+
+static uint64_t find_indexed(const WindowIndex &p_index, const std::string &p_name) {
+	const std::vector<uint64_t> *ids = p_index.find(p_name);
+	return ids ? ids->front() : 0;
+}
+
+static void test_add_remove_rename() {
+	WindowIndex index;
+	index.add(1, "Preview");
+	index.add(2, "Preview");
+	index.add(1, "Other");
+	assert(index.size() == 2);
+	assert(*index.find("Preview") == std::vector<uint64_t>({ 1, 2 }));
+	assert(!index.find("Other"));
+
+	index.rename(1, "Main");
+	assert(*index.find("Preview") == std::vector<uint64_t>({ 2 }));
+	assert(*index.find("Main") == std::vector<uint64_t>({ 1 }));
+
+	index.remove(2);
+	index.remove(2);
+	assert(!index.find("Preview"));
+	assert(!index.contains(2));
+	assert(index.contains(1));
+
+	index.clear();
+	assert(index.size() == 0);
+	assert(!index.find("Main"));
+}
+
+static void test_lookup_matches_tree_walk() {
+	std::vector<TestNode> nodes = build_tree();
+	WindowIndex index;
+	scan(nodes, 0, index);
+	assert(index.size() == NODE_COUNT / WINDOW_EVERY - 1);
+
+	std::vector<std::string> names;
+	for (size_t i = 1; i < NODE_COUNT / WINDOW_EVERY; i++) {
+		names.push_back("Window" + std::to_string(i));
+	}
+	names.push_back("Missing");
+	for (const std::string &name : names) {
+		assert(find_indexed(index, name) == find_linear(nodes, 0, name));
+	}
+
+	// Renamed and removed windows, as the node_renamed / node_removed
+	// handlers report them.
+	nodes[WINDOW_EVERY * 5].name = "Renamed";
+	index.rename(WINDOW_EVERY * 5 + 1, "Renamed");
+	nodes[WINDOW_EVERY * 7].window = false;
+	index.remove(WINDOW_EVERY * 7 + 1);
+	for (const std::string &name : { std::string("Renamed"), std::string("Window5"), std::string("Window7") }) {
+		assert(find_indexed(index, name) == find_linear(nodes, 0, name));
+	}
+}
+
+// find_child() returned nullptr when a plain node with the name came before
+// the Window, the index only knows Windows.
+static void test_non_window_nodes_are_ignored() {
+	std::vector<TestNode> nodes = build_tree();
+	nodes[1].name = "Window3";
+	WindowIndex index;
+	scan(nodes, 0, index);
+	assert(find_indexed(index, "Window3") == WINDOW_EVERY * 3 + 1);
+
+	// Windows added after the scan (node_added) come after the scanned
+	// ones, regardless of their position in the tree.
+	index.add(2, "Window3");
+	assert(find_indexed(index, "Window3") == WINDOW_EVERY * 3 + 1);
+}
+
+static void test_lookup_benchmark() {
+	typedef std::chrono::steady_clock Clock;
+	std::vector<TestNode> nodes = build_tree();
+	WindowIndex index;
+	scan(nodes, 0, index);
+
+	const int LOOKUPS = 200;
+	std::vector<std::string> names;
+	for (int i = 0; i < LOOKUPS; i++) {
+		// Half of them miss, which is the worst case for the walk.
+		names.push_back(i % 2 ? "Missing" + std::to_string(i) : "Window" + std::to_string(1 + i % 98));
+	}
+
+	uint64_t found = 0;
+	Clock::time_point start = Clock::now();
+	for (const std::string &name : names) {
+		found += find_linear(nodes, 0, name);
+	}
+	double linear_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / LOOKUPS;
+
+	uint64_t found_indexed = 0;
+	start = Clock::now();
+	for (const std::string &name : names) {
+		found_indexed += find_indexed(index, name);
+	}
+	double indexed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / LOOKUPS;
+
+	assert(found == found_indexed);
+	// Only reported, timings are not reliable enough under load to assert on.
+	printf("%zu nodes: %.0f ns per lookup walking the tree, %.0f ns indexed\n", NODE_COUNT, linear_ns, indexed_ns);
+}
+
+int main() {
+	RUN_TEST(test_add_remove_rename);
+	RUN_TEST(test_lookup_matches_tree_walk);
+	RUN_TEST(test_non_window_nodes_are_ignored);
+	RUN_TEST(test_lookup_benchmark);
+	return 0;
+}